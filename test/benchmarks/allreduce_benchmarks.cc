@@ -0,0 +1,109 @@
+#include "vw/allreduce/allreduce.h"
+#include "vw/io/logger.h"
+#include "vw/spanning_tree/spanning_tree.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+namespace
+{
+void add_float(float& c1, const float& c2) { c1 += c2; }
+
+size_t next_unique_id()
+{
+  static size_t counter = 0;
+  return static_cast<size_t>(getpid()) * 1000 + counter++;
+}
+
+// Node 0 reduces on the benchmark thread while every other node runs on its own thread and keeps reducing until node 0
+// sets the trailing stop flag. Each node has its own AllReduce object, just like separate processes would.
+template <typename AllReduceT, typename MakeNodeT, typename ReduceT>
+void run_nodes(benchmark::State& state, size_t total, MakeNodeT make_node, ReduceT reduce)
+{
+  const size_t n = static_cast<size_t>(state.range(0));
+  std::vector<std::thread> peers;
+  for (size_t node = 1; node < total; node++)
+  {
+    peers.emplace_back([&make_node, &reduce, n, node]() {
+      std::unique_ptr<AllReduceT> all_reduce = make_node(node);
+      std::vector<float> buffer(n + 1, 1.f);
+      do
+      {
+        buffer[n] = 0.f;
+        reduce(*all_reduce, buffer.data(), n + 1);
+      } while (buffer[n] == 0.f);
+    });
+  }
+
+  std::unique_ptr<AllReduceT> all_reduce = make_node(0);
+  std::vector<float> buffer(n + 1, 1.f);
+  // The first call connects to the other nodes, keep it out of the measurement.
+  buffer[n] = 0.f;
+  reduce(*all_reduce, buffer.data(), n + 1);
+
+  for (auto _ : state)
+  {
+    buffer[n] = 0.f;
+    reduce(*all_reduce, buffer.data(), n + 1);
+    benchmark::ClobberMemory();
+  }
+
+  buffer[n] = 1.f;
+  reduce(*all_reduce, buffer.data(), n + 1);
+  for (auto& peer : peers) { peer.join(); }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n * sizeof(float)));
+}
+
+void bench_allreduce_sockets(benchmark::State& state)
+{
+  const size_t total = static_cast<size_t>(state.range(1));
+  const size_t unique_id = next_unique_id();
+  VW::SpanningTree tree(0, true);
+  tree.Start();
+  auto logger = VW::io::create_null_logger();
+
+  run_nodes<AllReduceSockets>(
+      state, total,
+      [&](size_t node) {
+        return std::unique_ptr<AllReduceSockets>(
+            new AllReduceSockets("localhost", tree.BoundPort(), unique_id, total, node, true));
+      },
+      [&logger](AllReduceSockets& all_reduce, float* buffer, size_t n) {
+        all_reduce.all_reduce<float, add_float>(buffer, n, logger);
+      });
+  tree.Stop();
+}
+
+void bench_allreduce_shared_memory(benchmark::State& state)
+{
+  const size_t total = static_cast<size_t>(state.range(1));
+  const size_t unique_id = next_unique_id();
+
+  run_nodes<AllReduceSharedMemory>(
+      state, total,
+      [&](size_t node) {
+        return std::unique_ptr<AllReduceSharedMemory>(new AllReduceSharedMemory(unique_id, total, node, true));
+      },
+      [](AllReduceSharedMemory& all_reduce, float* buffer, size_t n) {
+        all_reduce.all_reduce<float, add_float>(buffer, n);
+      });
+}
+
+void allreduce_args(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"floats", "nodes"});
+  for (int64_t floats : {1 << 10, 1 << 16, 1 << 20})
+  {
+    for (int64_t nodes : {2, 4}) { b->Args({floats, nodes}); }
+  }
+  b->UseRealTime();
+}
+}  // namespace
+
+BENCHMARK(bench_allreduce_sockets)->Apply(allreduce_args);
+BENCHMARK(bench_allreduce_shared_memory)->Apply(allreduce_args);
+#endif
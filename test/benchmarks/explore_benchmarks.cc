@@ -0,0 +1,137 @@
+#include "action_score.h"
+#include "vw/explore/explore.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// std::vector iterators take the scalar loops of the exploration functions, while pointers and action_scores go
+// through the vectorized kernels when they are available.
+
+static std::vector<float> get_scores(size_t num_actions)
+{
+  std::vector<float> scores(num_actions);
+  for (size_t i = 0; i < num_actions; ++i) { scores[i] = std::sin(0.37f * static_cast<float>(i)); }
+  return scores;
+}
+
+static ACTION_SCORE::action_scores get_action_scores(size_t num_actions)
+{
+  ACTION_SCORE::action_scores a_s;
+  const auto scores = get_scores(num_actions);
+  for (size_t i = 0; i < num_actions; ++i) { a_s.push_back({static_cast<uint32_t>(i), scores[i]}); }
+  return a_s;
+}
+
+static void bench_softmax_scalar(benchmark::State& state)
+{
+  const auto scores = get_scores(static_cast<size_t>(state.range(0)));
+  std::vector<float> pmf(scores.size());
+  for (auto _ : state)
+  {
+    exploration::generate_softmax(-1.f, scores.begin(), scores.end(), pmf.begin(), pmf.end());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_softmax_vectorized(benchmark::State& state)
+{
+  const auto scores = get_scores(static_cast<size_t>(state.range(0)));
+  std::vector<float> pmf(scores.size());
+  for (auto _ : state)
+  {
+    exploration::generate_softmax(
+        -1.f, scores.data(), scores.data() + scores.size(), pmf.data(), pmf.data() + pmf.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_softmax_action_scores(benchmark::State& state)
+{
+  auto a_s = get_action_scores(static_cast<size_t>(state.range(0)));
+  const auto scores = get_scores(a_s.size());
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    for (size_t i = 0; i < a_s.size(); ++i) { a_s[i].score = scores[i]; }
+    state.ResumeTiming();
+    exploration::generate_softmax(-1.f, begin_scores(a_s), end_scores(a_s), begin_scores(a_s), end_scores(a_s));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename It>
+static void enforce_minimum_probability(It first, It last)
+{
+  exploration::enforce_minimum_probability(0.05f, true, first, last);
+}
+
+static void bench_enforce_minimum_probability_scalar(benchmark::State& state)
+{
+  auto pmf = get_scores(static_cast<size_t>(state.range(0)));
+  exploration::generate_softmax(-1.f, pmf.begin(), pmf.end(), pmf.begin(), pmf.end());
+  const auto initial = pmf;
+  for (auto _ : state)
+  {
+    pmf = initial;
+    enforce_minimum_probability(pmf.begin(), pmf.end());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_enforce_minimum_probability_vectorized(benchmark::State& state)
+{
+  auto pmf = get_scores(static_cast<size_t>(state.range(0)));
+  exploration::generate_softmax(-1.f, pmf.begin(), pmf.end(), pmf.begin(), pmf.end());
+  const auto initial = pmf;
+  for (auto _ : state)
+  {
+    pmf = initial;
+    enforce_minimum_probability(pmf.data(), pmf.data() + pmf.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_sample_after_normalizing_scalar(benchmark::State& state)
+{
+  auto pmf = get_scores(static_cast<size_t>(state.range(0)));
+  exploration::generate_softmax(-1.f, pmf.begin(), pmf.end(), pmf.begin(), pmf.end());
+  uint64_t seed = 7791;
+  uint32_t chosen_index = 0;
+  for (auto _ : state)
+  {
+    exploration::sample_after_normalizing(seed++ * 0x9e3779b97f4a7c15ULL, pmf.begin(), pmf.end(), chosen_index);
+    benchmark::DoNotOptimize(chosen_index);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bench_sample_after_normalizing_vectorized(benchmark::State& state)
+{
+  auto pmf = get_scores(static_cast<size_t>(state.range(0)));
+  exploration::generate_softmax(-1.f, pmf.begin(), pmf.end(), pmf.begin(), pmf.end());
+  uint64_t seed = 7791;
+  uint32_t chosen_index = 0;
+  for (auto _ : state)
+  {
+    exploration::sample_after_normalizing(
+        seed++ * 0x9e3779b97f4a7c15ULL, pmf.data(), pmf.data() + pmf.size(), chosen_index);
+    benchmark::DoNotOptimize(chosen_index);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(bench_softmax_scalar)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_softmax_vectorized)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_softmax_action_scores)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_enforce_minimum_probability_scalar)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_enforce_minimum_probability_vectorized)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_sample_after_normalizing_scalar)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(bench_sample_after_normalizing_vectorized)->RangeMultiplier(4)->Range(16, 4096);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "../benchmarks_common.h"
+#include "vw.h"
+
+// Compares the stacks fused by default with the same stacks called through the learner function pointers, which
+// matters most when there are few features per call.
+static void benchmark_fused_learn_simple(benchmark::State& state, std::string cmd, std::string example_string)
+{
+  auto vw = VW::initialize("--quiet " + cmd, nullptr, false, nullptr, nullptr);
+  auto* example = VW::read_example(*vw, example_string);
+
+  for (auto _ : state)
+  {
+    vw->learn(*example);
+    benchmark::ClobberMemory();
+  }
+  vw->finish_example(*example);
+  VW::finish(*vw);
+}
+
+static void benchmark_fused_cb_adf_learn(benchmark::State& state, std::string cmd, int actions)
+{
+  auto vw = VW::initialize("--cb_explore_adf --epsilon 0.1 --quiet " + cmd, nullptr, false, nullptr, nullptr);
+  multi_ex examples;
+  examples.push_back(VW::read_example(*vw, std::string("shared tag1| s_1 s_2")));
+  examples.push_back(VW::read_example(*vw, get_x_string_fts(2)));
+  for (int a = 1; a < actions; a++) { examples.push_back(VW::read_example(*vw, get_x_string_fts_no_label(2, a))); }
+
+  for (auto _ : state)
+  {
+    vw->learn(examples);
+    benchmark::ClobberMemory();
+  }
+  vw->finish_example(examples);
+  VW::finish(*vw);
+}
+
+BENCHMARK_CAPTURE(benchmark_fused_learn_simple, 1_feature_fused, "", "1 | a");
+BENCHMARK_CAPTURE(benchmark_fused_learn_simple, 1_feature_unfused, "--no_fused_stacks", "1 | a");
+BENCHMARK_CAPTURE(benchmark_fused_learn_simple, 8_features_logistic_fused, "--link logistic --loss_function logistic",
+    "1 |a b c d e f g h");
+BENCHMARK_CAPTURE(benchmark_fused_learn_simple, 8_features_logistic_unfused,
+    "--link logistic --loss_function logistic --no_fused_stacks", "1 |a b c d e f g h");
+
+BENCHMARK_CAPTURE(benchmark_fused_cb_adf_learn, 16_actions_fused, "", 16);
+BENCHMARK_CAPTURE(benchmark_fused_cb_adf_learn, 16_actions_unfused, "--no_fused_stacks", 16);
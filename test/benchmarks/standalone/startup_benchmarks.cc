@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "vw.h"
+
+// Compares setting up a workspace from its command line, which calls the setup function of every reduction, with
+// setting it up from the resolved setup of an identical workspace.
+static void benchmark_startup_command_line(benchmark::State& state, std::string cmd)
+{
+  for (auto _ : state)
+  {
+    auto* vw = VW::initialize("--quiet " + cmd, nullptr, false, nullptr, nullptr);
+    benchmark::DoNotOptimize(vw);
+    VW::finish(*vw);
+  }
+}
+
+static void benchmark_startup_resolved(benchmark::State& state, std::string cmd)
+{
+  auto* template_vw = VW::initialize("--quiet " + cmd, nullptr, false, nullptr, nullptr);
+  const auto setup = VW::resolve_setup(*template_vw);
+  VW::finish(*template_vw);
+
+  for (auto _ : state)
+  {
+    auto* vw = VW::initialize(setup);
+    benchmark::DoNotOptimize(vw);
+    VW::finish(*vw);
+  }
+}
+
+// Replicas sharing the model of a workspace, made by seeding from its options or cloning its resolved setup.
+static void benchmark_startup_replica(benchmark::State& state, std::string cmd, bool clone)
+{
+  auto* model = VW::initialize("--quiet " + cmd, nullptr, false, nullptr, nullptr);
+  const auto setup = VW::resolve_setup(*model);
+
+  for (auto _ : state)
+  {
+    auto* vw = clone ? VW::clone_vw_model(model, setup) : VW::seed_vw_model(model, " --quiet");
+    benchmark::DoNotOptimize(vw);
+    VW::finish(*vw);
+  }
+  VW::finish(*model);
+}
+
+BENCHMARK_CAPTURE(benchmark_startup_command_line, simple, "-b 10");
+BENCHMARK_CAPTURE(benchmark_startup_resolved, simple, "-b 10");
+BENCHMARK_CAPTURE(benchmark_startup_command_line, oaa, "-b 10 --oaa 10 -q ab");
+BENCHMARK_CAPTURE(benchmark_startup_resolved, oaa, "-b 10 --oaa 10 -q ab");
+BENCHMARK_CAPTURE(benchmark_startup_command_line, cb_explore_adf, "-b 10 --cb_explore_adf --epsilon 0.1 -q ::");
+BENCHMARK_CAPTURE(benchmark_startup_resolved, cb_explore_adf, "-b 10 --cb_explore_adf --epsilon 0.1 -q ::");
+BENCHMARK_CAPTURE(benchmark_startup_replica, seed_cb_explore_adf, "--cb_explore_adf --epsilon 0.1 -q ::", false);
+BENCHMARK_CAPTURE(benchmark_startup_replica, clone_cb_explore_adf, "--cb_explore_adf --epsilon 0.1 -q ::", true);
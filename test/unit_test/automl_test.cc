@@ -43,6 +43,16 @@ void check_interactions_match_exclusions(VW::reductions::automl::automl<interact
   }
 }
 
+void check_interactions_match_full_rebuild(VW::reductions::automl::automl<interaction_config_manager>* aml)
+{
+  for (uint64_t live_slot = 0; live_slot < aml->cm->scores.size(); ++live_slot)
+  {
+    auto incremental = aml->cm->scores[live_slot].live_interactions;
+    aml->cm->gen_quadratic_interactions(live_slot);
+    BOOST_CHECK(incremental == aml->cm->scores[live_slot].live_interactions);
+  }
+}
+
 void check_config_states(VW::reductions::automl::automl<interaction_config_manager>* aml)
 {
   // No configs in the index queue should be live
@@ -263,6 +273,8 @@ BOOST_AUTO_TEST_CASE(namespace_switch)
     VW::reductions::automl::automl<interaction_config_manager>* aml = aml_test::get_automl_data(all);
     size_t tser_count = aml->cm->ns_counter.at('T');
     BOOST_CHECK_GT(tser_count, 1);
+    aml_test::check_interactions_match_exclusions(aml);
+    aml_test::check_interactions_match_full_rebuild(aml);
 
     // reset user namespace to appropriate value
     sim.user_ns = "User";
@@ -0,0 +1,103 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "batch_predict.h"
+
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+ACTION_SCORE::action_scores predict_one(VW::workspace& vw, const std::vector<std::string>& lines)
+{
+  VW::multi_ex examples;
+  for (const auto& line : lines) { examples.push_back(VW::read_example(vw, line)); }
+  vw.predict(examples);
+  ACTION_SCORE::action_scores prediction = examples[0]->pred.a_s;
+  vw.finish_example(examples);
+  return prediction;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(batch_predictor_matches_single_requests)
+{
+  const std::string model_file = "batch_predict_test.model";
+  {
+    auto& vw = *VW::initialize("--cb_explore_adf --epsilon 0.1 -q UA --quiet -f " + model_file);
+    const std::vector<std::vector<std::string>> train = {
+        {"shared |U u1", "0:1.0:0.5 |A a1", "|A a2", "|A a3"},
+        {"shared |U u2", "|A a1", "0:-1.0:0.5 |A a2", "|A a3"},
+        {"shared |U u1 u2", "|A a1", "|A a2", "0:-0.5:0.5 |A a3"}};
+    for (int pass = 0; pass < 5; pass++)
+    {
+      for (const auto& lines : train)
+      {
+        VW::multi_ex examples;
+        for (const auto& line : lines) { examples.push_back(VW::read_example(vw, line)); }
+        vw.learn(examples);
+        vw.finish_example(examples);
+      }
+    }
+    VW::finish(vw);
+  }
+
+  std::vector<std::vector<std::string>> requests;
+  for (int i = 0; i < 20; i++)
+  {
+    const std::string shared = (i % 3 == 0) ? "shared |U u1" : (i % 3 == 1) ? "shared |U u2" : "shared |U u1 u2";
+    std::vector<std::string> request = {shared, "|A a1", "|A a2", "|A a3"};
+    if (i % 2 == 0) { request.emplace_back("|A a1 a3"); }
+    requests.push_back(request);
+  }
+
+  auto& reference = *VW::initialize("-t --quiet -i " + model_file);
+  auto& replica_1 = *VW::initialize("-t --quiet -i " + model_file);
+  auto& replica_2 = *VW::initialize("-t --quiet -i " + model_file);
+  std::vector<ACTION_SCORE::action_scores> expected;
+  for (const auto& request : requests) { expected.push_back(predict_one(reference, request)); }
+
+  auto check_batch = [&requests, &expected](VW::batch_predictor& predictor, size_t count) {
+    const std::vector<std::vector<std::string>> batch(requests.begin(), requests.begin() + count);
+    std::vector<ACTION_SCORE::action_scores> predictions;
+    predictor.predict(batch, predictions);
+    BOOST_REQUIRE_EQUAL(predictions.size(), count);
+    for (size_t i = 0; i < count; i++)
+    {
+      BOOST_REQUIRE_EQUAL(predictions[i].size(), expected[i].size());
+      for (size_t j = 0; j < expected[i].size(); j++)
+      {
+        BOOST_CHECK_EQUAL(predictions[i][j].action, expected[i][j].action);
+        BOOST_CHECK_CLOSE(predictions[i][j].score, expected[i][j].score, 1e-3f);
+      }
+    }
+  };
+
+  {
+    VW::batch_predictor single(reference);
+    VW::batch_predictor threaded({&replica_1, &replica_2});
+    for (auto* predictor : {&single, &threaded})
+    {
+      // The second batch reuses the pooled examples and the threads of the first one.
+      for (int batch = 0; batch < 2; batch++) { check_batch(*predictor, requests.size()); }
+    }
+
+    std::vector<ACTION_SCORE::action_scores> predictions;
+    BOOST_CHECK_THROW(single.predict({{}}, predictions), VW::vw_exception);
+  }
+
+  {
+    // Batches smaller than the number of workspaces leave some threads idle, which then join the next batch.
+    VW::batch_predictor wide({&reference, &replica_1, &replica_2});
+    for (size_t count : {2, 1, 20, 3}) { check_batch(wide, count); }
+  }
+
+  VW::finish(reference);
+  VW::finish(replica_1);
+  VW::finish(replica_2);
+  std::remove(model_file.c_str());
+}
@@ -4,7 +4,16 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "action_score.h"
+#include "io_buf.h"
 #include "vw.h"
+#include "vw/io/io_adapter.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <memory>
+#include <string>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(cb_explore_adf_should_throw_empty_multi_example) {
   auto vw = VW::initialize("--cb_explore_adf --quiet", nullptr, false, nullptr, nullptr);
@@ -14,3 +23,313 @@ BOOST_AUTO_TEST_CASE(cb_explore_adf_should_throw_empty_multi_example) {
   BOOST_REQUIRE_THROW(vw->learn(example_collection), VW::vw_exception);
   VW::finish(*vw);
 }
+
+namespace
+{
+std::vector<float> predict_scores(VW::workspace& vw, const std::vector<const char*>& lines)
+{
+  VW::multi_ex examples;
+  for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+  vw.predict(examples);
+  const auto& a_s = examples[0]->pred.a_s;
+  std::vector<float> scores(a_s.size());
+  for (const auto& as : a_s) { scores[as.action] = as.score; }
+  vw.finish_example(examples);
+  return scores;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(cb_adf_shared_features_scored_once_match_merged_actions) {
+  for (const std::string args : {"--cb_adf", "--cb_explore_adf --bag 3", "--cb_explore_adf --cover 2"})
+  {
+    auto& vw = *VW::initialize(args + " -q UA -q UU --quiet --random_seed 5", nullptr, false, nullptr, nullptr);
+    const std::vector<std::vector<const char*>> train = {
+        {"shared |U u1 u2:0.5", "0:1.0:0.5 |A a1", "|A a2 a3", "|A a4"},
+        {"shared |U u2 u3", "|A a1", "0:-1.0:0.5 |A a2 a3", "|A a4"},
+        {"shared |U u1 u3:2", "|A a1", "|A a2 a3", "0:0.5:0.3 |A a4"}};
+    for (int pass = 0; pass < 5; pass++)
+    {
+      for (const auto& lines : train)
+      {
+        VW::multi_ex examples;
+        for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+        vw.learn(examples);
+        vw.finish_example(examples);
+      }
+    }
+
+    // The shared namespace is only present in the shared example, so its score is computed once for all actions.
+    const auto with_shared = predict_scores(vw, {"shared |U u1 u2:0.5 u3", "|A a1", "|A a2 a3", "|A a4"});
+    const auto merged =
+        predict_scores(vw, {"|U u1 u2:0.5 u3 |A a1", "|U u1 u2:0.5 u3 |A a2 a3", "|U u1 u2:0.5 u3 |A a4"});
+
+    BOOST_REQUIRE_EQUAL(with_shared.size(), merged.size());
+    for (size_t i = 0; i < merged.size(); i++) { BOOST_CHECK_SMALL(with_shared[i] - merged[i], 1e-5f); }
+    VW::finish(vw);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_shared_features_rewritten_below_merger_match_merged_actions) {
+  // lrq appends features to the shared namespace merged into an action, for every other example counter.
+  auto& vw = *VW::initialize("--cb_adf --lrq UA2 -q UU --quiet --random_seed 5", nullptr, false, nullptr, nullptr);
+  const std::vector<std::vector<const char*>> train = {{"shared |U u1 u2:0.5", "0:1.0:0.5 |A a1", "|A a2 a3", "|A a4"},
+      {"shared |U u2 u3", "|A a1", "0:-1.0:0.5 |A a2 a3", "|A a4"},
+      {"shared |U u1 u3:2", "|A a1", "|A a2 a3", "0:0.5:0.3 |A a4"}};
+  for (int pass = 0; pass < 5; pass++)
+  {
+    for (const auto& lines : train)
+    {
+      VW::multi_ex examples;
+      for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+      vw.learn(examples);
+      vw.finish_example(examples);
+    }
+  }
+
+  const auto with_shared = predict_scores(vw, {"shared |U u1 u2:0.5 u3", "|A a1", "|A a2 a3", "|A a4"});
+  // lrq picks its left namespace by the parity of the example counter, which the shared example advanced by one.
+  VW::finish_example(vw, *VW::read_example(vw, "|A a1"));
+  const auto merged =
+      predict_scores(vw, {"|U u1 u2:0.5 u3 |A a1", "|U u1 u2:0.5 u3 |A a2 a3", "|U u1 u2:0.5 u3 |A a4"});
+
+  BOOST_REQUIRE_EQUAL(with_shared.size(), merged.size());
+  for (size_t i = 0; i < merged.size(); i++) { BOOST_CHECK_SMALL(with_shared[i] - merged[i], 1e-5f); }
+  VW::finish(vw);
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_shared_features_with_generated_interactions_match_merged_actions) {
+  auto& trained = *VW::initialize("--cb_adf -q :: --quiet --random_seed 5", nullptr, false, nullptr, nullptr);
+  const std::vector<std::vector<const char*>> train = {{"shared |U u1 u2:0.5", "0:1.0:0.5 |A a1", "|A a2 |B b1", "|A a4"},
+      {"shared |U u2 u3", "|A a1 |B b2", "0:-1.0:0.5 |A a2", "|A a4"},
+      {"shared |U u1 u3:2", "|A a1", "|A a2 |B b1", "0:0.5:0.3 |A a4 |B b2"}};
+  for (int pass = 0; pass < 5; pass++)
+  {
+    for (const auto& lines : train)
+    {
+      VW::multi_ex examples;
+      for (auto* line : lines) { examples.push_back(VW::read_example(trained, line)); }
+      trained.learn(examples);
+      trained.finish_example(examples);
+    }
+  }
+
+  auto model = std::make_shared<std::vector<char>>();
+  io_buf model_writer;
+  model_writer.add_file(VW::io::create_vector_writer(model));
+  VW::save_predictor(trained, model_writer);
+  VW::finish(trained);
+
+  // A loaded model has not seen any namespace yet, so the second action regenerates the interactions the first one
+  // was scored with.
+  io_buf model_reader;
+  model_reader.add_file(VW::io::create_buffer_view(model->data(), model->size()));
+  auto& vw = *VW::initialize("--quiet", &model_reader, false, nullptr, nullptr);
+  const auto with_shared = predict_scores(vw, {"shared |U u1 u2:0.5 u3", "|A a1", "|A a2 |B b1 b2", "|A a4"});
+  const auto merged = predict_scores(
+      vw, {"|U u1 u2:0.5 u3 |A a1", "|U u1 u2:0.5 u3 |A a2 |B b1 b2", "|U u1 u2:0.5 u3 |A a4"});
+
+  BOOST_REQUIRE_EQUAL(with_shared.size(), merged.size());
+  for (size_t i = 0; i < merged.size(); i++) { BOOST_CHECK_SMALL(with_shared[i] - merged[i], 1e-5f); }
+  VW::finish(vw);
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_multipredict_matches_predict_per_policy) {
+  // dr keeps a second slot per policy in cb_adf, so it goes through the generic one predict per policy path.
+  for (const std::string args : {"--cb_explore_adf --bag 4", "--cb_explore_adf --bag 4 --cb_type dr"})
+  {
+    auto& vw = *VW::initialize(args + " -q UA --quiet --random_seed 7", nullptr, false, nullptr, nullptr);
+    const std::vector<std::vector<const char*>> train = {{"0:1.0:0.5 |U u1 |A a1", "|U u1 |A a2", "|U u1 |A a3"},
+        {"|U u2 |A a1", "0:-1.0:0.5 |U u2 |A a2", "|U u2 |A a3"},
+        {"|U u1 u2 |A a1", "|U u1 u2 |A a2", "0:0.5:0.3 |U u1 u2 |A a3"}};
+    for (int pass = 0; pass < 5; pass++)
+    {
+      for (const auto& lines : train)
+      {
+        VW::multi_ex examples;
+        for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+        vw.learn(examples);
+        vw.finish_example(examples);
+      }
+    }
+
+    auto* cb_adf = as_multiline(vw.l->get_learner_by_name_prefix("cb_adf"));
+    VW::multi_ex examples;
+    for (auto* line : {"|U u1 u2:0.5 |A a1", "|U u1 u2:0.5 |A a2", "|U u1 u2:0.5 |A a3"})
+    { examples.push_back(VW::read_example(vw, line)); }
+
+    std::vector<VW::polyprediction> fused(4);
+    cb_adf->multipredict(examples, 0, fused.size(), fused.data(), false);
+    for (size_t i = 0; i < fused.size(); i++)
+    {
+      cb_adf->predict(examples, i);
+      const auto& expected = examples[0]->pred.a_s;
+      BOOST_REQUIRE_EQUAL(fused[i].a_s.size(), expected.size());
+      for (size_t j = 0; j < expected.size(); j++)
+      {
+        BOOST_CHECK_EQUAL(fused[i].a_s[j].action, expected[j].action);
+        BOOST_CHECK_SMALL(fused[i].a_s[j].score - expected[j].score, 1e-5f);
+      }
+    }
+    vw.finish_example(examples);
+    VW::finish(vw);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sort_top_k_orders_best_actions_and_boundary_ties) {
+  ACTION_SCORE::action_scores a_s;
+  const std::vector<float> scores = {0.5f, -1.f, 2.f, 0.25f, 0.25f, 3.f, -0.5f, 0.25f};
+  for (uint32_t i = 0; i < scores.size(); i++) { a_s.push_back({i, scores[i]}); }
+
+  VW::sort_top_k(a_s, 3);
+  BOOST_REQUIRE_EQUAL(a_s.size(), scores.size());
+  // The best three, then the two actions tied with the third.
+  const std::vector<uint32_t> expected_front = {1, 6, 3, 4, 7};
+  for (size_t i = 0; i < expected_front.size(); i++) { BOOST_CHECK_EQUAL(a_s[i].action, expected_front[i]); }
+  for (size_t i = expected_front.size(); i < a_s.size(); i++) { BOOST_CHECK_GT(a_s[i].score, 0.25f); }
+
+  VW::sort_top_k(a_s, 0);
+  for (size_t i = 1; i < a_s.size(); i++) { BOOST_CHECK(VW::action_score_compare_lt(a_s[i - 1], a_s[i])); }
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_action_candidate_filter_ranks_pruned_actions_last) {
+  auto& vw = *VW::initialize("--cb_adf --rank_top_k 1 --quiet", nullptr, false, nullptr, nullptr);
+  const std::vector<std::vector<const char*>> train = {{"0:1.0:0.5 |A a1", "|A a2", "|A a3"},
+      {"|A a1", "0:-1.0:0.5 |A a2", "|A a3"}, {"|A a1", "|A a2", "0:-0.5:0.5 |A a3"}};
+  for (int pass = 0; pass < 5; pass++)
+  {
+    for (const auto& lines : train)
+    {
+      VW::multi_ex examples;
+      for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+      vw.learn(examples);
+      vw.finish_example(examples);
+    }
+  }
+
+  const std::vector<const char*> test = {"|A a1", "|A a2", "|A a3"};
+  const auto all_scores = predict_scores(vw, test);
+
+  size_t filter_calls = 0;
+  vw.action_candidate_filter = [&filter_calls](const VW::multi_ex& actions, size_t index) {
+    BOOST_CHECK_EQUAL(actions.size(), 3);
+    ++filter_calls;
+    return index != 1;
+  };
+  const auto pruned_scores = predict_scores(vw, test);
+  vw.action_candidate_filter = nullptr;
+
+  BOOST_CHECK_EQUAL(filter_calls, 3);
+  BOOST_REQUIRE_EQUAL(pruned_scores.size(), 3);
+  BOOST_CHECK_CLOSE(pruned_scores[0], all_scores[0], 1e-3f);
+  BOOST_CHECK_EQUAL(pruned_scores[1], FLT_MAX);
+  BOOST_CHECK_CLOSE(pruned_scores[2], all_scores[2], 1e-3f);
+  VW::finish(vw);
+}
+
+BOOST_AUTO_TEST_CASE(cb_candidates_explores_over_shortlist_of_actions) {
+  const std::vector<std::vector<const char*>> train = {
+      {"shared |U u1", "0:1.0:0.5 |A a1", "|A a2", "|A a3", "|A a4", "|A a5"},
+      {"shared |U u2", "|A a1", "0:-1.0:0.5 |A a2", "|A a3", "|A a4", "|A a5"},
+      {"shared |U u1 u2", "|A a1", "|A a2", "|A a3", "0:-0.5:0.5 |A a4", "|A a5"}};
+  const std::vector<const char*> test = {"shared |U u1 u2", "|A a1", "|A a2", "|A a3", "|A a4", "|A a5"};
+
+  auto train_and_predict = [&](const std::string& args) {
+    auto& vw = *VW::initialize(args + " --lrq UA2 --quiet --random_seed 3", nullptr, false, nullptr, nullptr);
+    for (int pass = 0; pass < 5; pass++)
+    {
+      for (const auto& lines : train)
+      {
+        VW::multi_ex examples;
+        for (auto* line : lines) { examples.push_back(VW::read_example(vw, line)); }
+        vw.learn(examples);
+        vw.finish_example(examples);
+      }
+    }
+    const auto probs = predict_scores(vw, test);
+    VW::finish(vw);
+    return probs;
+  };
+
+  // With at least as many candidates as actions, every action is scored as usual.
+  const auto all_probs = train_and_predict("--cb_explore_adf --epsilon 0.1");
+  const auto passthrough_probs = train_and_predict("--cb_explore_adf --epsilon 0.1 --cb_candidates 5");
+  BOOST_REQUIRE_EQUAL(passthrough_probs.size(), all_probs.size());
+  for (size_t i = 0; i < all_probs.size(); i++) { BOOST_CHECK_CLOSE(passthrough_probs[i], all_probs[i], 1e-3f); }
+
+  // Otherwise the actions left out of the shortlist only get their share of the exploration mass.
+  const auto shortlist_probs = train_and_predict("--cb_explore_adf --epsilon 0.1 --cb_candidates 2");
+  BOOST_REQUIRE_EQUAL(shortlist_probs.size(), 5);
+  const float uniform = 0.05f / 5;
+  size_t shortlisted = 0;
+  float total = 0.f;
+  for (auto prob : shortlist_probs)
+  {
+    if (prob > 1.01f * uniform) { ++shortlisted; }
+    else
+    {
+      BOOST_CHECK_CLOSE(prob, uniform, 1e-3f);
+    }
+    total += prob;
+  }
+  BOOST_CHECK_EQUAL(shortlisted, 2);
+  BOOST_CHECK_CLOSE(total, 1.f, 1e-3f);
+}
+
+BOOST_AUTO_TEST_CASE(cb_candidates_shortlist_is_top_k_of_actions) {
+  constexpr size_t NUM_CANDIDATES = 3;
+  constexpr int NUM_ACTIONS = 8;
+  for (const std::string args : {"-q UA", "-q UA -q AA", "--lrq UA2"})
+  {
+    // Trained on no more actions than the shortlist holds, so that both models learn the same.
+    auto train = [&args](const std::string& extra_args) {
+      auto* vw = VW::initialize("--cb_adf " + args + extra_args + " --quiet --random_seed 3", nullptr, false, nullptr,
+          nullptr);
+      for (int i = 0; i < 60; i++)
+      {
+        VW::multi_ex examples;
+        examples.push_back(VW::read_example(*vw, "shared |U u" + std::to_string(i % 4) + " u" + std::to_string(i % 3)));
+        for (int a = 0; a < static_cast<int>(NUM_CANDIDATES); a++)
+        {
+          const int action = (i + 3 * a) % NUM_ACTIONS;
+          const std::string label = a == i % 3 ? "0:" + std::to_string((action + i) % 5 - 2) + ":0.3 " : "";
+          examples.push_back(VW::read_example(
+              *vw, label + "|A a" + std::to_string(action) + " b" + std::to_string(action % 3)));
+        }
+        vw->learn(examples);
+        vw->finish_example(examples);
+      }
+      return vw;
+    };
+
+    auto& all_vw = *train("");
+    auto& candidates_vw = *train(" --cb_candidates " + std::to_string(NUM_CANDIDATES));
+    for (const std::string context : {"shared |U u1 u2", "shared |U u0 u3:0.5", "shared |U u2"})
+    {
+      std::vector<std::string> lines = {context};
+      for (int a = 0; a < NUM_ACTIONS; a++)
+      { lines.push_back("|A a" + std::to_string(a) + " b" + std::to_string(a % 3)); }
+      std::vector<const char*> test;
+      for (const auto& line : lines) { test.push_back(line.c_str()); }
+
+      const auto all_scores = predict_scores(all_vw, test);
+      const auto shortlist_scores = predict_scores(candidates_vw, test);
+      BOOST_REQUIRE_EQUAL(all_scores.size(), NUM_ACTIONS);
+      BOOST_REQUIRE_EQUAL(shortlist_scores.size(), NUM_ACTIONS);
+
+      std::vector<size_t> ranking(NUM_ACTIONS);
+      for (size_t a = 0; a < ranking.size(); a++) { ranking[a] = a; }
+      std::sort(ranking.begin(), ranking.end(), [&](size_t l, size_t r) { return all_scores[l] < all_scores[r]; });
+      for (size_t rank = 0; rank < ranking.size(); rank++)
+      {
+        const size_t action = ranking[rank];
+        if (rank < NUM_CANDIDATES) { BOOST_CHECK_CLOSE(shortlist_scores[action], all_scores[action], 1e-3f); }
+        else
+        {
+          BOOST_CHECK_EQUAL(shortlist_scores[action], FLT_MAX);
+        }
+      }
+    }
+    VW::finish(all_vw);
+    VW::finish(candidates_vw);
+  }
+}
@@ -0,0 +1,129 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "example_arena.h"
+
+#include "v_array.h"
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(example_arena_merges_chunks_on_reset)
+{
+  VW::example_arena arena;
+  auto* first = static_cast<char*>(arena.allocate(100, 8));
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(first) % 8, 0);
+  BOOST_CHECK(arena.try_extend(first, 100, 200));
+  arena.allocate(10000, 8);
+  BOOST_CHECK(!arena.try_extend(first, 200, 300));
+  BOOST_CHECK_GE(arena.used(), 10200);
+  const size_t capacity = arena.capacity();
+
+  arena.reset();
+  BOOST_CHECK_EQUAL(arena.used(), 0);
+  BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+  // Everything allocated before the reset now fits in the merged chunk.
+  auto* merged = static_cast<char*>(arena.allocate(10200, 8));
+  BOOST_CHECK(arena.try_extend(merged, 10200, capacity));
+
+  arena.reset(1);
+  BOOST_CHECK_LT(arena.capacity(), capacity);
+  BOOST_CHECK_EQUAL(arena.resets(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(v_array_grows_in_arena)
+{
+  VW::example_arena arena;
+  VW::v_array<uint64_t> values;
+  values.use_arena(&arena);
+  for (uint64_t i = 0; i < 1000; i++) { values.push_back(i); }
+  for (uint64_t i = 0; i < 1000; i++) { BOOST_CHECK_EQUAL(values[i], i); }
+
+  // Copies do not share the arena, moves carry it along.
+  VW::v_array<uint64_t> copy = values;
+  BOOST_CHECK(copy.arena() == nullptr);
+  VW::v_array<uint64_t> moved = std::move(values);
+  BOOST_CHECK(moved.arena() == &arena);
+  BOOST_CHECK_EQUAL(moved.size(), 1000);
+
+  moved.release_arena_storage();
+  arena.reset();
+  moved.push_back(7);
+  BOOST_CHECK_EQUAL(moved[0], 7);
+  BOOST_CHECK_EQUAL(copy[999], 999);
+}
+
+BOOST_AUTO_TEST_CASE(v_array_arena_shares_word_with_erase_count)
+{
+  // The arena takes no room of its own, v_array is as large as before it could use one.
+  BOOST_CHECK_EQUAL(sizeof(VW::v_array<float>), 3 * sizeof(float*) + sizeof(size_t));
+
+  // Heap storage is still trimmed after 1024 clears.
+  VW::v_array<uint64_t> values;
+  for (uint64_t i = 0; i < 100; i++) { values.push_back(i); }
+  for (int i = 0; i < 1024; i++) { values.clear(); }
+  BOOST_CHECK_LT(values.capacity(), 100);
+  BOOST_CHECK(values.arena() == nullptr);
+
+  VW::example_arena arena;
+  values.use_arena(&arena);
+  for (uint64_t i = 0; i < 100; i++) { values.push_back(i); }
+  for (int i = 0; i < 2048; i++) { values.clear(); }
+  BOOST_CHECK(values.arena() == &arena);
+  BOOST_CHECK_GE(values.capacity(), 100);
+  values.use_arena(nullptr);
+  BOOST_CHECK(values.arena() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(example_arena_learns_like_heap_features)
+{
+  std::vector<std::vector<float>> predictions;
+  for (const std::string args : {"", "--example_arena", "--compact_features"})
+  {
+    auto& vw = *VW::initialize(args + " -q fg --quiet");
+    predictions.emplace_back();
+    for (int i = 0; i < 3000; i++)
+    {
+      std::string line = i % 3 == 0 ? "1 |f" : "-1 |f";
+      // Examples of varying size, so that the arenas grow, are merged and get trimmed.
+      for (int f = 0; f < (i * 7) % 40; f++) { line += " a" + std::to_string((i + f) % 23); }
+      line += " |g b" + std::to_string(i % 5);
+      auto* ec = VW::read_example(vw, line);
+      vw.learn(*ec);
+      predictions.back().push_back(ec->pred.scalar);
+      VW::finish_example(vw, *ec);
+    }
+    VW::finish(vw);
+  }
+
+  for (size_t run = 1; run < predictions.size(); run++)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[0].size(), predictions[run].size());
+    for (size_t i = 0; i < predictions[0].size(); i++) { BOOST_CHECK_EQUAL(predictions[0][i], predictions[run][i]); }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compact_features_are_contiguous)
+{
+  auto& vw = *VW::initialize("--compact_features --quiet");
+  for (const std::string line : {"1 |a x y |b z", "1 |b z w v u |a x |c t", "1 |a x y |b z"})
+  {
+    auto* ec = VW::read_example(vw, line);
+    const feature_value* next_value = nullptr;
+    const feature_index* next_index = nullptr;
+    for (const auto ns : ec->indices)
+    {
+      const auto& fs = ec->feature_space[ns];
+      if (next_value != nullptr) { BOOST_CHECK(fs.values.begin() == next_value); }
+      if (next_index != nullptr) { BOOST_CHECK(fs.indices.begin() == next_index); }
+      next_value = fs.values.begin() + fs.values.capacity();
+      next_index = fs.indices.begin() + fs.indices.capacity();
+    }
+    VW::finish_example(vw, *ec);
+  }
+  VW::finish(vw);
+}
@@ -9,6 +9,10 @@
 
 #include "feature_group.h"
 #include "unique_sort.h"
+#include "vw.h"
+
+#include <memory>
+#include <string>
 
 BOOST_AUTO_TEST_CASE(unique_feature_group_test)
 {
@@ -160,3 +164,49 @@ BOOST_AUTO_TEST_CASE(iterate_extents_test)
     BOOST_REQUIRE_EQUAL(std::distance((*begin).first, (*begin).second), 5);
   }
 }
+
+BOOST_AUTO_TEST_CASE(audit_strings_list_builds_references_lazily_test)
+{
+  auto source = std::make_shared<const std::string>(" ns a b:str");
+  VW::audit_strings_list space_names;
+  space_names.push_back_lazy(source, {1, 2, 4, 1, 0, 0});
+  space_names.push_back_lazy(source, {1, 2, 6, 1, 8, 3});
+  BOOST_CHECK_EQUAL(space_names.size(), 2);
+  BOOST_CHECK_EQUAL(space_names.get(1).name, "b");
+  BOOST_CHECK_EQUAL(space_names.get(1).str_value, "str");
+
+  // Copies keep the source alive, and strings added directly go after the references.
+  VW::audit_strings_list copy = space_names;
+  source.reset();
+  space_names.clear();
+  copy.emplace_back("", "Constant");
+  BOOST_REQUIRE_EQUAL(copy.size(), 3);
+  BOOST_CHECK_EQUAL(copy[0].ns, "ns");
+  BOOST_CHECK_EQUAL(copy[0].name, "a");
+  BOOST_CHECK_EQUAL(copy[0].str_value, "");
+  BOOST_CHECK_EQUAL(copy[1].name, "b");
+  BOOST_CHECK_EQUAL(copy[2].name, "Constant");
+}
+
+BOOST_AUTO_TEST_CASE(text_parser_audit_strings_test)
+{
+  auto* vw = VW::initialize("--audit --quiet");
+  auto* ex = VW::read_example(*vw, "1 |user a b:2 c:str | d");
+
+  const auto& user = ex->feature_space['u'].space_names;
+  BOOST_REQUIRE_EQUAL(user.size(), 3);
+  BOOST_CHECK_EQUAL(user[0].ns, "user");
+  BOOST_CHECK_EQUAL(user[0].name, "a");
+  BOOST_CHECK_EQUAL(user[1].name, "b");
+  BOOST_CHECK_EQUAL(user[1].str_value, "");
+  BOOST_CHECK_EQUAL(user[2].name, "c");
+  BOOST_CHECK_EQUAL(user[2].str_value, "str");
+
+  const auto& default_namespace = ex->feature_space[' '].space_names;
+  BOOST_REQUIRE_EQUAL(default_namespace.size(), 1);
+  BOOST_CHECK_EQUAL(default_namespace[0].ns, " ");
+  BOOST_CHECK_EQUAL(default_namespace[0].name, "d");
+
+  VW::finish_example(*vw, *ex);
+  VW::finish(*vw);
+}
@@ -0,0 +1,73 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<float> learn_simple(const std::string& args)
+{
+  auto& vw = *VW::initialize(args + " --quiet");
+  std::vector<float> predictions;
+  for (int i = 0; i < 200; i++)
+  {
+    const std::string label = i % 3 == 0 ? "1" : "-1";
+    auto* ec = VW::read_example(vw, label + " |f a" + std::to_string(i % 7) + " b:" + std::to_string(i % 3) + " |g c");
+    vw.learn(*ec);
+    predictions.push_back(ec->pred.scalar);
+    VW::finish_example(vw, *ec);
+  }
+  auto* test = VW::read_example(vw, "|f a1 b:2 |g c");
+  vw.predict(*test);
+  predictions.push_back(test->pred.scalar);
+  VW::finish_example(vw, *test);
+  VW::finish(vw);
+  return predictions;
+}
+
+std::vector<float> learn_cb_adf(const std::string& args)
+{
+  auto& vw = *VW::initialize(args + " --quiet");
+  std::vector<float> pmfs;
+  for (int i = 0; i < 100; i++)
+  {
+    VW::multi_ex examples;
+    examples.push_back(VW::read_example(vw, "shared |s u" + std::to_string(i % 3)));
+    for (int a = 0; a < 3; a++)
+    {
+      const std::string label = a == i % 3 ? "0:" + std::to_string(a == 1 ? -1 : 0) + ":0.5 " : "";
+      examples.push_back(VW::read_example(vw, label + "|a x" + std::to_string(a)));
+    }
+    vw.learn(examples);
+    for (const auto& as : examples[0]->pred.a_s) { pmfs.push_back(as.score); }
+    vw.finish_example(examples);
+  }
+  VW::finish(vw);
+  return pmfs;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(fused_stacks_learn_like_unfused_stacks)
+{
+  for (const std::string args : {"", "--link logistic --loss_function logistic", "--link glf1", "--power_t 0.4",
+           "--sgd", "--l1 0.001", "-q fg"})
+  {
+    BOOST_TEST_CONTEXT("args: " << args)
+    {
+      const auto fused = learn_simple(args);
+      const auto unfused = learn_simple(args + " --no_fused_stacks");
+      BOOST_REQUIRE_EQUAL(fused.size(), unfused.size());
+      for (size_t i = 0; i < fused.size(); i++) { BOOST_CHECK_EQUAL(fused[i], unfused[i]); }
+    }
+  }
+
+  const auto fused = learn_cb_adf("--cb_explore_adf -q sa");
+  const auto unfused = learn_cb_adf("--cb_explore_adf -q sa --no_fused_stacks");
+  BOOST_REQUIRE_EQUAL(fused.size(), unfused.size());
+  for (size_t i = 0; i < fused.size(); i++) { BOOST_CHECK_EQUAL(fused[i], unfused[i]); }
+}
@@ -0,0 +1,112 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw.h"
+#include "vw/common/vw_exception.h"
+
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#  include <arpa/inet.h>
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+BOOST_AUTO_TEST_CASE(metrics_snapshot_file_is_written_while_learning)
+{
+  const std::string snapshot_file = "metrics_snapshot_test.json";
+  std::remove(snapshot_file.c_str());
+
+  auto& vw = *VW::initialize("--metrics_snapshot_file " + snapshot_file + " --metrics_snapshot_interval 0.001 --quiet");
+  for (int i = 0; i < 1000; i++)
+  {
+    auto* ec = VW::read_example(vw, std::to_string(i % 2) + " |f a b c" + std::to_string(i % 7));
+    vw.learn(*ec);
+    VW::finish_example(vw, *ec);
+    // Snapshots are considered every few examples, and at most once per interval.
+    if (i % 100 == 0) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+  }
+  // Stops the exporter, which writes the last snapshot it was handed.
+  VW::finish(vw);
+
+  std::ifstream snapshot(snapshot_file);
+  BOOST_REQUIRE(snapshot.good());
+  std::stringstream contents;
+  contents << snapshot.rdbuf();
+  for (const char* key :
+      {"total_learn_calls", "examples_per_second", "parse_queue_depth", "example_pool_allocated", "average_loss"})
+  { BOOST_CHECK_NE(contents.str().find(key), std::string::npos); }
+  snapshot.close();
+  std::remove(snapshot_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(metrics_snapshot_interval_must_be_positive)
+{
+  BOOST_CHECK_THROW(
+      VW::initialize("--metrics_snapshot_file unused.json --metrics_snapshot_interval 0 --quiet"), VW::vw_exception);
+}
+
+#ifndef _WIN32
+namespace
+{
+int connect_to(uint16_t port)
+{
+  const int sock = socket(PF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  BOOST_REQUIRE_EQUAL(connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+  return sock;
+}
+
+uint16_t unused_port()
+{
+  const int sock = socket(PF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t size = sizeof(address);
+  BOOST_REQUIRE_EQUAL(bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+  BOOST_REQUIRE_EQUAL(getsockname(sock, reinterpret_cast<sockaddr*>(&address), &size), 0);
+  close(sock);
+  return ntohs(address.sin_port);
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(metrics_port_survives_client_closing_before_reading)
+{
+  const uint16_t port = unused_port();
+  auto& vw = *VW::initialize("--metrics_port " + std::to_string(port) + " --quiet");
+
+  // The connection is reset before a request is sent, so the server reads the reset and its reply raises SIGPIPE
+  // unless that is disabled.
+  const int dropped = connect_to(port);
+  linger abort_on_close{};
+  abort_on_close.l_onoff = 1;
+  abort_on_close.l_linger = 0;
+  setsockopt(dropped, SOL_SOCKET, SO_LINGER, &abort_on_close, sizeof(abort_on_close));
+  close(dropped);
+
+  const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+  const int client = connect_to(port);
+  send(client, request.data(), request.size(), 0);
+  std::string response;
+  std::array<char, 4096> buffer;
+  ssize_t received = 0;
+  while ((received = recv(client, buffer.data(), buffer.size(), 0)) > 0) { response.append(buffer.data(), received); }
+  close(client);
+  BOOST_CHECK_EQUAL(response.find("HTTP/1.0 200 OK"), 0);
+
+  VW::finish(vw);
+}
+#endif
@@ -7,8 +7,9 @@
 
 #include "object_pool.h"
 
-#include <vector>
 #include <string>
+#include <thread>
+#include <vector>
 
 struct obj
 {
@@ -67,3 +68,79 @@ BOOST_AUTO_TEST_CASE(object_pool_test)
 
   pool.return_object(o2);
 }
+
+BOOST_AUTO_TEST_CASE(sharded_object_pool_test)
+{
+  VW::sharded_object_pool<obj> pool{8, 4};
+  BOOST_CHECK_EQUAL(pool.num_shards(), 4);
+  BOOST_CHECK_EQUAL(pool.size(), 8);
+
+  // Objects are taken from the other shards before new ones are allocated.
+  std::vector<obj*> objects;
+  pool.get_objects(10, objects);
+  BOOST_CHECK_EQUAL(objects.size(), 10);
+  BOOST_CHECK_EQUAL(pool.size(), 10);
+  BOOST_CHECK_EQUAL(pool.empty(), true);
+  BOOST_CHECK_EQUAL(pool.stats().allocated, 10);
+  BOOST_CHECK_GE(pool.stats().stolen, 6);
+
+  obj other_obj;
+  BOOST_CHECK_EQUAL(pool.is_from_pool(objects[9]), true);
+  BOOST_CHECK_EQUAL(pool.is_from_pool(&other_obj), false);
+
+  pool.return_objects(objects);
+  BOOST_CHECK_EQUAL(pool.empty(), false);
+  auto* o = pool.get_object();
+  BOOST_CHECK_EQUAL(pool.size(), 10);
+  pool.return_object(o);
+  BOOST_CHECK_EQUAL(pool.stats().acquired, 11);
+  BOOST_CHECK_EQUAL(pool.stats().returned, 11);
+}
+
+BOOST_AUTO_TEST_CASE(sharded_object_pool_trims_above_high_water)
+{
+  VW::sharded_object_pool<obj> pool{0, 2, 3};
+  std::vector<obj*> objects;
+  pool.get_objects(5, objects);
+  pool.return_objects(objects);
+  BOOST_CHECK_EQUAL(pool.size(), 3);
+  BOOST_CHECK_EQUAL(pool.stats().trimmed, 2);
+
+  auto* o = pool.get_object();
+  BOOST_CHECK_EQUAL(pool.is_from_pool(o), true);
+  pool.return_object(o);
+}
+
+BOOST_AUTO_TEST_CASE(sharded_object_pool_concurrent_test)
+{
+  VW::sharded_object_pool<obj> pool{0, 4, 64};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([&pool, t]() {
+      std::vector<obj*> objects;
+      for (int i = 0; i < 2000; i++)
+      {
+        if (i % 3 == 0) { pool.get_objects(4, objects); }
+        else
+        {
+          objects.push_back(pool.get_object());
+        }
+        for (auto* o : objects) { o->i = t; }
+        if (i % 2 == 0)
+        {
+          pool.return_objects(objects);
+          objects.clear();
+        }
+      }
+      pool.return_objects(objects);
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  const auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.acquired, stats.returned);
+  BOOST_CHECK_EQUAL(pool.size(), stats.allocated - stats.trimmed);
+  // The high-water mark is not exact when threads return objects at the same time, each of them may keep a batch.
+  BOOST_CHECK_LE(pool.size(), 64 + 4 * 5);
+}
@@ -0,0 +1,101 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "offline_eval.h"
+
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// A log of uniformly random decisions over three actions, where the best action depends on the user.
+std::string generate_log(size_t num_events, double& mean_cost)
+{
+  std::stringstream log;
+  mean_cost = 0.;
+  for (size_t i = 0; i < num_events; i++)
+  {
+    const size_t user = i % 2;
+    const size_t action = (i * 7 + i / 3) % 3;
+    const float cost = action == user ? -1.f : 0.f;
+    mean_cost += cost;
+    log << R"({"_label_cost":)" << cost << R"(,"_label_probability":0.3333333,"_label_Action":)" << action + 1
+        << R"(,"_labelIndex":)" << action << R"(,"a":[1,2,3],"c":{"U":{"user":"u)" << user
+        << R"("},"_multi":[{"A":{"a":"a1"}},{"A":{"a":"a2"}},{"A":{"a":"a3"}}]},"p":[0.3333333,0.3333333,0.3333333]})"
+        << "\n";
+  }
+  mean_cost /= num_events;
+  return log.str();
+}
+
+std::vector<VW::policy_estimates> evaluate(
+    const std::string& log, const std::vector<std::string>& policy_args, size_t num_threads)
+{
+  auto* reader = VW::initialize("--cb_adf --dsjson -q UA --quiet");
+  std::vector<VW::workspace*> policies;
+  for (const auto& args : policy_args) { policies.push_back(VW::initialize(args + " -q UA --quiet")); }
+
+  std::vector<VW::policy_estimates> estimates;
+  {
+    VW::offline_evaluator evaluator(*reader, policies, num_threads);
+    std::stringstream log_stream(log);
+    evaluator.evaluate(log_stream);
+    estimates = evaluator.estimates();
+  }
+
+  for (auto* policy : policies) { VW::finish(*policy); }
+  VW::finish(*reader);
+  return estimates;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(offline_evaluator_estimates_policies_in_one_pass)
+{
+  double mean_cost = 0.;
+  const std::string log = generate_log(300, mean_cost);
+  const std::vector<std::string> policy_args = {"--cb_explore_adf --epsilon 1", "--cb_explore_adf --epsilon 0.1",
+      "--cb_explore_adf --softmax --lambda 4", "--cb_explore_adf --epsilon 0.1 --cb_type dr"};
+
+  const auto estimates = evaluate(log, policy_args, 1);
+  BOOST_REQUIRE_EQUAL(estimates.size(), policy_args.size());
+  for (const auto& e : estimates)
+  {
+    BOOST_CHECK_EQUAL(e.events, 300);
+    BOOST_CHECK_LE(e.lower_bound, e.upper_bound);
+  }
+
+  // The uniformly random policy matches the logging policy, so every importance weight is 1.
+  BOOST_CHECK_CLOSE(estimates[0].ips, mean_cost, 1e-3);
+  BOOST_CHECK_CLOSE(estimates[0].snips, mean_cost, 1e-3);
+  BOOST_CHECK_LE(estimates[0].lower_bound, mean_cost);
+  BOOST_CHECK_GE(estimates[0].upper_bound, mean_cost);
+
+  // The learned policies find the best action of each user.
+  BOOST_CHECK_LT(estimates[1].ips, estimates[0].ips);
+  BOOST_CHECK_LT(estimates[1].dr, estimates[0].dr);
+
+  // Policies are evaluated independently, so the estimates do not depend on how they are spread over threads.
+  const auto threaded_estimates = evaluate(log, policy_args, 3);
+  BOOST_REQUIRE_EQUAL(threaded_estimates.size(), estimates.size());
+  for (size_t i = 0; i < estimates.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(threaded_estimates[i].events, estimates[i].events);
+    BOOST_CHECK_EQUAL(threaded_estimates[i].ips, estimates[i].ips);
+    BOOST_CHECK_EQUAL(threaded_estimates[i].snips, estimates[i].snips);
+    BOOST_CHECK_EQUAL(threaded_estimates[i].dr, estimates[i].dr);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(offline_evaluator_requires_json_reader)
+{
+  auto* reader = VW::initialize("--cb_adf --quiet");
+  auto* policy = VW::initialize("--cb_explore_adf --quiet");
+  BOOST_CHECK_THROW(VW::offline_evaluator(*reader, {policy}), VW::vw_exception);
+  VW::finish(*policy);
+  VW::finish(*reader);
+}
@@ -0,0 +1,128 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/parameter_server/parameter_server.h"
+
+#include "global_data.h"
+#include "io_buf.h"
+#include "learner.h"
+#include "vw.h"
+#include "vw/io/io_adapter.h"
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::string worker_args(const VW::parameter_server& server)
+{
+  return "--ps_servers localhost:" + std::to_string(server.bound_port()) +
+      " --ps_sync_period 4 -b 12 --noconstant --quiet";
+}
+
+void learn_lines(VW::workspace& vw, const std::string& line, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    auto* ec = VW::read_example(vw, line);
+    vw.learn(*ec);
+    VW::finish_example(vw, *ec);
+  }
+}
+
+float predict_line(VW::workspace& vw, const std::string& line)
+{
+  auto* ec = VW::read_example(vw, line);
+  vw.predict(*ec);
+  const float prediction = ec->pred.scalar;
+  VW::finish_example(vw, *ec);
+  return prediction;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(parameter_server_workers_share_what_they_learn)
+{
+  VW::parameter_server server(0, true);
+  server.start();
+
+  auto& first = *VW::initialize(worker_args(server));
+  auto& second = *VW::initialize(worker_args(server));
+
+  // Each worker only ever sees its own features, anything it knows about the others came from the server.
+  std::thread first_thread([&] { learn_lines(first, "1 |a x", 50); });
+  std::thread second_thread([&] { learn_lines(second, "-1 |b y", 50); });
+  first_thread.join();
+  second_thread.join();
+
+  // The end of the examples pulls the whole shard, the first worker pulls again once the second has pushed.
+  first.l->end_examples();
+  second.l->end_examples();
+  first.l->end_examples();
+
+  for (const std::string line : {"|a x", "|b y", "|a x |b y"})
+  { BOOST_CHECK_EQUAL(predict_line(first, line), predict_line(second, line)); }
+  BOOST_CHECK(predict_line(second, "|a x") > 0.5f);
+  BOOST_CHECK(predict_line(first, "|b y") < -0.5f);
+
+  const auto weights = server.weights();
+  BOOST_CHECK_EQUAL(weights.size(), first.length());
+  for (size_t i = 0; i < weights.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(first.weights.dense_weights.strided_index(i), weights[i]);
+    BOOST_CHECK_EQUAL(second.weights.dense_weights.strided_index(i), weights[i]);
+  }
+
+  VW::finish(first);
+  VW::finish(second);
+  server.stop();
+  BOOST_CHECK(server.pushes_applied() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(parameter_server_is_seeded_with_loaded_model)
+{
+  auto& model = *VW::initialize("-b 12 --noconstant --quiet");
+  learn_lines(model, "1 |c z", 50);
+
+  auto model_bytes = std::make_shared<std::vector<char>>();
+  io_buf model_writer;
+  model_writer.add_file(VW::io::create_vector_writer(model_bytes));
+  VW::save_predictor(model, model_writer);
+
+  VW::parameter_server server(0, true);
+  server.start();
+
+  io_buf model_reader;
+  model_reader.add_file(VW::io::create_buffer_view(model_bytes->data(), model_bytes->size()));
+  auto& worker = *VW::initialize(worker_args(server), &model_reader);
+
+  // Learning something unrelated must neither drop what the loaded model knows nor push it a second time. Predictions
+  // are clipped to the labels seen, so the weights are compared instead.
+  learn_lines(worker, "-1 |a x", 8);
+  worker.l->end_examples();
+  worker.l->end_examples();
+  const auto weights = server.weights();
+  size_t num_seeded = 0;
+  for (size_t i = 0; i < weights.size(); i++)
+  {
+    const float expected = model.weights.dense_weights.strided_index(i);
+    if (expected == 0.f) { continue; }
+    ++num_seeded;
+    BOOST_CHECK_CLOSE(weights[i], expected, 1e-3);
+    BOOST_CHECK_CLOSE(worker.weights.dense_weights.strided_index(i), expected, 1e-3);
+  }
+  BOOST_CHECK(num_seeded > 0);
+
+  auto& late_worker = *VW::initialize(worker_args(server));
+  learn_lines(late_worker, "-1 |a x", 1);
+  late_worker.l->end_examples();
+  BOOST_CHECK(predict_line(late_worker, "|c z") > 0.5f);
+
+  VW::finish(worker);
+  VW::finish(late_worker);
+  VW::finish(model);
+  server.stop();
+}
@@ -0,0 +1,152 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "predict_context.h"
+
+#include "global_data.h"
+#include "shared_data.h"
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr int NUM_THREADS = 4;
+
+std::string simple_line(int i)
+{
+  std::string line = "|a";
+  for (int f = 0; f < 1 + i % 6; f++) { line += " x" + std::to_string((i + f) % 13); }
+  return line + " |b y" + std::to_string(i % 4);
+}
+
+std::vector<std::string> adf_lines(int i)
+{
+  std::vector<std::string> lines{"shared |s u" + std::to_string(i % 3)};
+  for (int a = 0; a < 4; a++)
+  {
+    const std::string label = i % 4 == a ? std::to_string(a + 1) + ":-1:0.25 " : "";
+    lines.push_back(label + "|a x" + std::to_string(a) + " z" + std::to_string((i + a) % 5));
+  }
+  return lines;
+}
+
+std::vector<float> action_scores(const VW::example& ec)
+{
+  std::vector<float> scores;
+  for (const auto& a_s : ec.pred.a_s)
+  {
+    scores.push_back(static_cast<float>(a_s.action));
+    scores.push_back(a_s.score);
+  }
+  return scores;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(predict_contexts_predict_concurrently_like_the_model)
+{
+  auto& model = *VW::initialize("-q ab --quiet");
+  for (int i = 0; i < 500; i++)
+  {
+    auto* ec = VW::read_example(model, (i % 3 == 0 ? "1 " : "-1 ") + simple_line(i));
+    model.learn(*ec);
+    VW::finish_example(model, *ec);
+  }
+
+  std::vector<float> expected;
+  for (int i = 0; i < 50; i++)
+  {
+    auto* ec = VW::read_example(model, simple_line(i));
+    model.predict(*ec);
+    expected.push_back(ec->pred.scalar);
+    VW::finish_example(model, *ec);
+  }
+  const auto examples_seen = model.sd->example_number;
+
+  const auto setup = VW::resolve_setup(model);
+  std::vector<std::unique_ptr<VW::predict_context>> contexts;
+  for (int t = 0; t < NUM_THREADS; t++) { contexts.emplace_back(new VW::predict_context(model, setup)); }
+  BOOST_CHECK(contexts[0]->get_workspace().weights.dense_weights.first() == model.weights.dense_weights.first());
+
+  std::vector<std::vector<float>> predictions(NUM_THREADS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; t++)
+  {
+    threads.emplace_back([&, t] {
+      for (int pass = 0; pass < 20; pass++)
+      {
+        predictions[t].clear();
+        for (int i = 0; i < 50; i++)
+        {
+          auto* ec = contexts[t]->read_example(simple_line(i));
+          contexts[t]->predict(*ec);
+          predictions[t].push_back(ec->pred.scalar);
+          contexts[t]->finish_example(*ec);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  for (const auto& thread_predictions : predictions)
+  {
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        thread_predictions.begin(), thread_predictions.end(), expected.begin(), expected.end());
+  }
+  BOOST_CHECK_EQUAL(model.sd->example_number, examples_seen);
+
+  contexts.clear();
+  VW::finish(model);
+}
+
+BOOST_AUTO_TEST_CASE(predict_contexts_predict_multi_examples)
+{
+  auto& model = *VW::initialize("--cb_explore_adf --epsilon 0.1 -q sa --quiet");
+  for (int i = 0; i < 200; i++)
+  {
+    VW::multi_ex examples;
+    for (const auto& line : adf_lines(i)) { examples.push_back(VW::read_example(model, line)); }
+    model.learn(examples);
+    model.finish_example(examples);
+  }
+
+  std::vector<std::vector<float>> expected;
+  for (int i = 0; i < 20; i++)
+  {
+    VW::multi_ex examples;
+    for (const auto& line : adf_lines(i)) { examples.push_back(VW::read_example(model, line)); }
+    model.predict(examples);
+    expected.push_back(action_scores(*examples[0]));
+    model.finish_example(examples);
+  }
+
+  std::vector<std::unique_ptr<VW::predict_context>> contexts;
+  for (int t = 0; t < NUM_THREADS; t++) { contexts.emplace_back(new VW::predict_context(model)); }
+
+  std::vector<std::vector<std::vector<float>>> predictions(NUM_THREADS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < NUM_THREADS; t++)
+  {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 20; i++)
+      {
+        VW::multi_ex examples;
+        for (const auto& line : adf_lines(i)) { examples.push_back(contexts[t]->read_example(line)); }
+        contexts[t]->predict(examples);
+        predictions[t].push_back(action_scores(*examples[0]));
+        contexts[t]->finish_example(examples);
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+
+  for (const auto& thread_predictions : predictions) { BOOST_CHECK(thread_predictions == expected); }
+
+  contexts.clear();
+  VW::finish(model);
+}
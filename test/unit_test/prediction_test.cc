@@ -7,6 +7,10 @@
 
 #include "vw.h"
 
+#include <cstdio>
+#include <string>
+#include <vector>
+
 // Test case validating this issue: https://github.com/VowpalWabbit/vowpal_wabbit/issues/2166
 BOOST_AUTO_TEST_CASE(predict_modifying_state)
 {
@@ -44,3 +48,99 @@ BOOST_AUTO_TEST_CASE(predict_modifying_state)
 
   BOOST_CHECK_EQUAL(prediction_one, prediction_two);
 }
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(shared_weights_predict_like_model)
+{
+  const std::string model_file = "shared_weights_test.model";
+  const std::string weights_file = "shared_weights_test.weights";
+  {
+    auto& vw = *VW::initialize("--quiet --predict_only_model -b 12 --power_t 0 -f " + model_file +
+        " --save_shared_weights " + weights_file);
+    for (auto* line : {"1 | a b c", "-1 | b d", "0.5 | a:2 e", "1 | c e f"})
+    {
+      auto& ex = *VW::read_example(vw, line);
+      vw.learn(ex);
+      vw.finish_example(ex);
+    }
+    VW::finish(vw);
+  }
+
+  auto predict = [](const std::string& args) {
+    auto& vw = *VW::initialize("--quiet -t " + args);
+    auto& ex = *VW::read_example(vw, "| a b e");
+    vw.predict(ex);
+    float prediction = ex.pred.scalar;
+    vw.finish_example(ex);
+    VW::finish(vw);
+    return prediction;
+  };
+
+  const float from_model = predict("-i " + model_file);
+  const float from_shared_weights = predict("-i " + model_file + " --shared_weights " + weights_file);
+  BOOST_CHECK_NE(from_model, 0.f);
+  BOOST_CHECK_EQUAL(from_model, from_shared_weights);
+
+  // The weights are mapped read only, so learning from them is rejected.
+  BOOST_CHECK_THROW(VW::initialize("--quiet -i " + model_file + " --shared_weights " + weights_file), VW::vw_exception);
+
+  // Everything but the weights still comes from the model.
+  try
+  {
+    VW::initialize("--quiet -t --shared_weights " + weights_file);
+    BOOST_ERROR("--shared_weights without -i did not throw");
+  }
+  catch (const VW::vw_exception& e)
+  {
+    BOOST_CHECK(std::string(e.what()).find("requires the model to be given with -i") != std::string::npos);
+  }
+
+  std::remove(model_file.c_str());
+  std::remove(weights_file.c_str());
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(dense_model_weights_predict_like_records)
+{
+  const std::vector<const char*> examples = {"1 | a b c", "-1 | b d", "0.5 | a:2 e", "1 | c e f"};
+  auto train = [&examples](const std::string& args) {
+    auto& vw = *VW::initialize("--quiet -b 12 " + args);
+    for (auto* line : examples)
+    {
+      auto& ex = *VW::read_example(vw, line);
+      vw.learn(ex);
+      vw.finish_example(ex);
+    }
+    VW::finish(vw);
+  };
+  auto predict = [](const std::string& args, bool expect_mapped) {
+    auto& vw = *VW::initialize("--quiet " + args);
+    BOOST_CHECK_EQUAL(vw.weights.dense_weights.mapped(), expect_mapped);
+    auto& ex = *VW::read_example(vw, "| a b e");
+    vw.predict(ex);
+    float prediction = ex.pred.scalar;
+    vw.finish_example(ex);
+    VW::finish(vw);
+    return prediction;
+  };
+
+  train("--predict_only_model -f dense_model_test.records");
+  train("--predict_only_model --dense_model_weights -f dense_model_test.dense");
+  train("--dense_model_weights -f dense_model_test.resume");
+
+  const float from_records = predict("-t -i dense_model_test.records", false);
+  BOOST_CHECK_NE(from_records, 0.f);
+#ifndef _WIN32
+  const bool mapped_when_testing = true;
+#else
+  const bool mapped_when_testing = false;
+#endif
+  BOOST_CHECK_EQUAL(predict("-t -i dense_model_test.dense", mapped_when_testing), from_records);
+  BOOST_CHECK_EQUAL(predict("-t -i dense_model_test.resume", mapped_when_testing), from_records);
+  // Models which are going to learn copy the weights instead of mapping them.
+  BOOST_CHECK_EQUAL(predict("-i dense_model_test.dense", false), from_records);
+  BOOST_CHECK_EQUAL(predict("-i dense_model_test.resume", false), from_records);
+
+  for (auto* file : {"dense_model_test.records", "dense_model_test.dense", "dense_model_test.resume"})
+  { std::remove(file); }
+}
@@ -0,0 +1,47 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "reduction_profiler.h"
+
+#include "learner.h"
+#include "metric_sink.h"
+#include "vw.h"
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(profile_reductions_times_each_learner)
+{
+  auto& vw =
+      *VW::initialize("--cb_explore_adf -q UA --quiet --extra_metrics ut_metrics.json --profile_reductions");
+  const std::vector<std::vector<const char*>> train = {{"shared |U u1", "0:1.0:0.5 |A a1", "|A a2", "|A a3"},
+      {"shared |U u2", "|A a1", "0:-1.0:0.5 |A a2", "|A a3"}};
+  for (int i = 0; i < 10; i++)
+  {
+    VW::multi_ex examples;
+    for (auto* line : train[i % 2]) { examples.push_back(VW::read_example(vw, line)); }
+    vw.learn(examples);
+    vw.finish_example(examples);
+  }
+
+  VW::metric_sink metrics;
+  vw.l->persist_metrics(metrics);
+
+  BOOST_CHECK_EQUAL(metrics.get_uint("profile.cb_adf.learn.calls"), 10);
+  BOOST_CHECK_LE(metrics.get_uint("profile.cb_adf.learn.self_ns"), metrics.get_uint("profile.cb_adf.learn.total_ns"));
+  BOOST_CHECK_LE(metrics.get_uint("profile.cb_adf.learn.p50_ns"), metrics.get_uint("profile.cb_adf.learn.max_ns"));
+  BOOST_CHECK_GE(metrics.get_uint("profile.gd.learn.calls"), 10);
+  // The learners below a reduction are part of its total time, but not of its self time.
+  BOOST_CHECK_GE(metrics.get_uint("profile.cb_adf.learn.total_ns"), metrics.get_uint("profile.gd.learn.total_ns"));
+
+  // finish_example is attributed to the reduction which implements it.
+  BOOST_CHECK_EQUAL(metrics.get_uint("profile.cb_explore_adf_greedy.finish_example.calls"), 10);
+  VW::finish(vw);
+}
+
+BOOST_AUTO_TEST_CASE(profile_reductions_requires_extra_metrics)
+{
+  BOOST_CHECK_THROW(VW::initialize("--cb_explore_adf --quiet --profile_reductions"), VW::vw_exception);
+}
@@ -0,0 +1,110 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "resolved_setup.h"
+
+#include "global_data.h"
+#include "vw.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/options.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<float> learn_predictions(VW::workspace& vw)
+{
+  std::vector<float> predictions;
+  for (int i = 0; i < 200; i++)
+  {
+    std::string line = i % 3 == 0 ? "1 |a" : "-1 |a";
+    for (int f = 0; f < i % 7; f++) { line += " x" + std::to_string((i + f) % 11); }
+    line += " |b y" + std::to_string(i % 5);
+    auto* ec = VW::read_example(vw, line);
+    vw.learn(*ec);
+    predictions.push_back(ec->pred.scalar);
+    VW::finish_example(vw, *ec);
+  }
+  return predictions;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(resolved_setup_serialization_round_trips)
+{
+  VW::resolved_setup setup;
+  setup.reductions = {"gd", "scorer", "count_label"};
+  setup.args = {"--l2", "0.5", "--text with spaces", ""};
+
+  const auto restored = VW::deserialize_resolved_setup(VW::serialize_resolved_setup(setup));
+  BOOST_CHECK(restored.reductions == setup.reductions);
+  BOOST_CHECK(restored.args == setup.args);
+
+  BOOST_CHECK_THROW(VW::deserialize_resolved_setup("--l2 0.5"), VW::vw_exception);
+  BOOST_CHECK_THROW(VW::deserialize_resolved_setup("vw_resolved_setup 1\n3\ngd\n"), VW::vw_exception);
+  setup.args.push_back("line\nbreak");
+  BOOST_CHECK_THROW(VW::serialize_resolved_setup(setup), VW::vw_exception);
+}
+
+BOOST_AUTO_TEST_CASE(resolved_setup_learns_like_command_line)
+{
+  for (const std::string args : {"", "--binary -q ab --l2 0.0001", "--nn 2 --power_t 0.25", "--bootstrap 3"})
+  {
+    auto& vw = *VW::initialize(args + " --quiet");
+    const auto setup = VW::deserialize_resolved_setup(VW::serialize_resolved_setup(VW::resolve_setup(vw)));
+    auto& resolved_vw = *VW::initialize(setup);
+
+    BOOST_CHECK(setup.reductions == vw.enabled_setup_functions);
+    BOOST_CHECK(resolved_vw.enabled_setup_functions == vw.enabled_setup_functions);
+    // Options of reductions that were not enabled are not defined at all.
+    BOOST_CHECK(resolved_vw.options->get_all_options().size() < vw.options->get_all_options().size());
+
+    const auto expected = learn_predictions(vw);
+    const auto predictions = learn_predictions(resolved_vw);
+    BOOST_CHECK_EQUAL_COLLECTIONS(predictions.begin(), predictions.end(), expected.begin(), expected.end());
+    VW::finish(vw);
+    VW::finish(resolved_vw);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(resolved_setup_keeps_options_of_enabled_reductions_only)
+{
+  auto& vw = *VW::initialize("--cb_explore_adf --epsilon 0.2 --quiet");
+  const auto setup = VW::resolve_setup(vw);
+  BOOST_CHECK(std::find(setup.reductions.begin(), setup.reductions.end(), "cb_explore_adf_greedy") !=
+      setup.reductions.end());
+  BOOST_CHECK(std::find(setup.args.begin(), setup.args.end(), "--epsilon") != setup.args.end());
+  BOOST_CHECK(std::find(setup.args.begin(), setup.args.end(), "--cb_explore_adf") != setup.args.end());
+  VW::finish(vw);
+
+  VW::resolved_setup unknown = setup;
+  unknown.reductions.push_back("not_a_reduction");
+  BOOST_CHECK_THROW(VW::initialize(unknown), VW::vw_exception);
+}
+
+BOOST_AUTO_TEST_CASE(clone_vw_model_shares_the_model)
+{
+  auto& vw = *VW::initialize("-q ab --quiet");
+  const auto setup = VW::resolve_setup(vw);
+  auto& clone = *VW::clone_vw_model(&vw, setup);
+  BOOST_CHECK(clone.enabled_setup_functions == vw.enabled_setup_functions);
+  BOOST_CHECK(clone.sd == vw.sd);
+  BOOST_CHECK(clone.weights.dense_weights.first() == vw.weights.dense_weights.first());
+
+  // What the clone learns is seen by the workspace it was cloned from.
+  learn_predictions(clone);
+  auto* ec = VW::read_example(vw, "|a x1 x2 |b y3");
+  auto* clone_ec = VW::read_example(clone, "|a x1 x2 |b y3");
+  vw.predict(*ec);
+  clone.predict(*clone_ec);
+  BOOST_CHECK(ec->pred.scalar != 0.f);
+  BOOST_CHECK_EQUAL(ec->pred.scalar, clone_ec->pred.scalar);
+  VW::finish_example(vw, *ec);
+  VW::finish_example(clone, *clone_ec);
+
+  VW::finish(clone);
+  VW::finish(vw);
+}
@@ -10,6 +10,13 @@
 
 #include "test_common.h"
 
+#include <cstdio>
+#include <vector>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
 constexpr auto LENGTH = 16;
 constexpr auto STRIDE_SHIFT = 2;
 
@@ -73,4 +80,36 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_feature_could_be_activated_but_feature_not_in
   }
   BOOST_CHECK_EQUAL(w.is_activated(feature_index), false);
 }
-#endif
\ No newline at end of file
+#endif
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(test_dense_map_read_only)
+{
+  constexpr size_t offset = 1 << 16;
+  std::vector<weight> values(LENGTH << STRIDE_SHIFT);
+  for (size_t i = 0; i < values.size(); i++) { values[i] = 0.5f * i; }
+
+  char path[] = "/tmp/vw_weights_test_XXXXXX";
+  int fd = mkstemp(path);
+  BOOST_REQUIRE(fd >= 0);
+  BOOST_REQUIRE_EQUAL(pwrite(fd, values.data(), values.size() * sizeof(weight), offset),
+      static_cast<ssize_t>(values.size() * sizeof(weight)));
+
+  {
+    dense_parameters w;
+    w.map_read_only(fd, offset, LENGTH, STRIDE_SHIFT);
+    close(fd);
+    unlink(path);
+
+    BOOST_CHECK(w.mapped());
+    BOOST_CHECK_EQUAL(w.stride_shift(), STRIDE_SHIFT);
+    BOOST_CHECK_EQUAL(w.mask(), (LENGTH << STRIDE_SHIFT) - 1);
+    for (size_t i = 0; i < LENGTH; i++) { BOOST_CHECK_CLOSE(w.strided_index(i), 0.5f * (i * w.stride()), FLOAT_TOL); }
+
+    // A shallow copy must not unmap the weights when it goes away.
+    dense_parameters copy;
+    copy.shallow_copy(w);
+    BOOST_CHECK(!copy.mapped());
+  }
+}
+#endif
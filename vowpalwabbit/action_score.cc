@@ -11,6 +11,8 @@
 #include "vw/common/string_view.h"
 #include "vw/io/logger.h"
 
+#include <algorithm>
+
 namespace ACTION_SCORE
 {
 void print_action_score(
@@ -49,4 +51,20 @@ std::string to_string(const ACTION_SCORE::action_scores& action_scores_or_probs,
   return ss.str();
 }
 
+void sort_top_k(ACTION_SCORE::action_scores& a_s, size_t k)
+{
+  if (k == 0 || k >= a_s.size())
+  {
+    std::sort(a_s.begin(), a_s.end(), action_score_compare_lt);
+    return;
+  }
+
+  auto top_end = a_s.begin() + k;
+  std::partial_sort(a_s.begin(), top_end, a_s.end(), action_score_compare_lt);
+  const float boundary = (top_end - 1)->score;
+  auto ties_end = std::partition(
+      top_end, a_s.end(), [boundary](const ACTION_SCORE::action_score& as) { return as.score == boundary; });
+  std::sort(top_end, ties_end, action_score_compare_lt);
+}
+
 }  // namespace VW
@@ -63,6 +63,21 @@ void print_action_score(
 std::ostream& operator<<(std::ostream& os, const action_score& a_s);
 }  // namespace ACTION_SCORE
 
+namespace exploration
+{
+template <typename It>
+struct strided_floats;
+
+// Lets the exploration functions run their vectorized kernels directly on the scores of action_scores.
+template <>
+struct strided_floats<ACTION_SCORE::score_iterator>
+{
+  static_assert(sizeof(ACTION_SCORE::action_score) == 2 * sizeof(float), "action_score must be two packed floats");
+  static constexpr bool value = true;
+  static constexpr size_t stride = 2;
+};
+}  // namespace exploration
+
 namespace VW
 {
 constexpr inline bool action_score_compare_lt(
@@ -76,6 +91,11 @@ constexpr inline bool action_score_compare_gt(
   return (left.score == right.score) ? left.action > right.action : left.score > right.score;
 }
 
+// Moves the k lowest scoring actions to the front, ordered by action_score_compare_lt, in O(n log k). Actions which
+// score the same as the k-th one are ordered right after it, so a tie at the boundary is kept together. The order of the
+// remaining actions is unspecified. A k of 0 sorts all actions.
+void sort_top_k(ACTION_SCORE::action_scores& a_s, size_t k);
+
 std::string to_string(
     const ACTION_SCORE::action_scores& action_scores_or_probs, int decimal_precision = DEFAULT_FLOAT_PRECISION);
 }  // namespace VW
\ No newline at end of file
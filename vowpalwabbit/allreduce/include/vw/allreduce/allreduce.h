@@ -6,6 +6,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 #include <utility>
 
@@ -65,7 +66,8 @@ constexpr size_t ar_buf_size = 1 << 16;
 enum class AllReduceType
 {
   Socket,
-  Thread
+  Thread,
+  SharedMemory
 };
 
 struct node_socks
@@ -308,3 +310,66 @@ public:
     broadcast((char*)buffer, n * sizeof(T));
   }
 };
+
+// Allreduce between processes on the same host through a POSIX shared memory segment. Each node owns a slot in the
+// segment which it copies its buffer into, every node then reduces a disjoint stripe across all slots and finally
+// copies the result back, so no data goes through the network stack.
+//
+// Node 0 creates the segment under a name made of the unique id and a random token, which it publishes in a small
+// segment named after the unique id only. Segments left behind by a run which crashed are therefore never attached to.
+// Waiting for the other nodes throws once one of them exited or after the timeout, rather than hanging forever.
+class AllReduceSharedMemory : public AllReduce
+{
+private:
+  size_t m_unique_id;
+  size_t m_timeout_seconds;
+  void* m_region;
+  size_t m_region_size;
+
+  void attach();
+  void barrier();
+  void check_peers() const;
+  char* slot(size_t i) const { return static_cast<char*>(m_region) + header_size + i * slot_size; }
+
+public:
+  // Bytes reserved at the start of the segment for the barrier and the process ids of the nodes, followed by one slot
+  // of slot_size bytes per node.
+  static constexpr size_t header_size = 4096;
+  static constexpr size_t slot_size = 1 << 20;
+  static constexpr size_t default_timeout_seconds = 600;
+
+  AllReduceSharedMemory(const size_t punique_id, const size_t ptotal, const size_t pnode, bool pquiet = false,
+      size_t ptimeout_seconds = default_timeout_seconds);
+
+  virtual ~AllReduceSharedMemory();
+
+  template <class T, void (*f)(T&, const T&)>
+  void all_reduce(T* buffer, const size_t n)
+  {
+    if (m_region == nullptr) { attach(); }
+
+    const size_t chunk = slot_size / sizeof(T);
+    // Stripes are cache line multiples so that nodes never write to the same line.
+    const size_t per_line = std::max<size_t>(1, 64 / sizeof(T));
+    T* result = reinterpret_cast<T*>(slot(0));
+    T* mine = reinterpret_cast<T*>(slot(node));
+
+    for (size_t begin = 0; begin < n; begin += chunk)
+    {
+      const size_t len = std::min(chunk, n - begin);
+      memcpy(mine, buffer + begin, len * sizeof(T));
+      barrier();
+
+      const size_t stripe = ((len + total - 1) / total + per_line - 1) / per_line * per_line;
+      const size_t lo = std::min(len, node * stripe);
+      const size_t hi = std::min(len, lo + stripe);
+      // One contiguous pass per peer slot keeps the inner loop vectorizable.
+      for (size_t i = 1; i < total; i++) addbufs<T, f>(result + lo, reinterpret_cast<const T*>(slot(i)) + lo, hi - lo);
+      barrier();
+
+      memcpy(buffer + begin, result, len * sizeof(T));
+      // Nobody may overwrite the slots with the next chunk until everyone has read the result.
+      barrier();
+    }
+  }
+};
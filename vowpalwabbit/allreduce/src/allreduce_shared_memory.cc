@@ -0,0 +1,266 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+/*
+This implements the allreduce function through POSIX shared memory for processes on a single host.
+*/
+#include "vw/allreduce/allreduce.h"
+#include "vw/common/vw_exception.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+// Lives at the start of the shared segment, followed by the process id of each node. ftruncate() zero fills the
+// segment, which is a valid initial state.
+struct shm_header
+{
+  std::atomic<uint32_t> waiting;
+  std::atomic<uint32_t> generation;
+};
+
+// The segment named after the unique id only, through which node 0 tells the others where the data segment is. The
+// token is written last, a zero token means node 0 is not done yet.
+struct shm_rendezvous
+{
+  std::atomic<int32_t> creator;
+  std::atomic<uint64_t> token;
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "The shared memory barrier requires lock free atomics");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The shared memory rendezvous requires lock free atomics");
+static_assert(sizeof(shm_header) <= AllReduceSharedMemory::header_size, "Header does not fit");
+
+constexpr size_t MAX_NODES = (AllReduceSharedMemory::header_size - sizeof(shm_header)) / sizeof(std::atomic<int32_t>);
+
+// How long the other nodes wait for node 0 to create the segment.
+constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(60);
+// How often a waiting node checks whether the others are still alive.
+constexpr auto PEER_CHECK_INTERVAL = std::chrono::milliseconds(100);
+
+std::string rendezvous_name(size_t unique_id) { return "/vw_allreduce_" + std::to_string(unique_id); }
+
+std::string segment_name(size_t unique_id, uint64_t token)
+{
+  return rendezvous_name(unique_id) + "_" + std::to_string(token);
+}
+
+#ifndef _WIN32
+std::atomic<int32_t>* node_pids(void* region)
+{
+  return reinterpret_cast<std::atomic<int32_t>*>(static_cast<char*>(region) + sizeof(shm_header));
+}
+
+bool process_alive(int32_t pid) { return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH; }
+
+uint64_t make_token()
+{
+  std::random_device device;
+  uint64_t token = (static_cast<uint64_t>(device()) << 32) ^ device() ^ static_cast<uint64_t>(getpid()) ^
+      static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  return token == 0 ? 1 : token;
+}
+
+// Token of the published segment and the process id of the node 0 which created it, 0 if there is none yet.
+uint64_t read_rendezvous(const std::string& name, int32_t& creator)
+{
+  creator = 0;
+  int fd = shm_open(name.c_str(), O_RDONLY, 0600);
+  if (fd < 0) { return 0; }
+  struct stat info;
+  void* region = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == sizeof(shm_rendezvous))
+  { region = mmap(nullptr, sizeof(shm_rendezvous), PROT_READ, MAP_SHARED, fd, 0); }
+  close(fd);
+  if (region == MAP_FAILED) { return 0; }
+
+  const auto* rendezvous = static_cast<const shm_rendezvous*>(region);
+  const uint64_t token = rendezvous->token.load(std::memory_order_acquire);
+  creator = rendezvous->creator.load(std::memory_order_relaxed);
+  munmap(region, sizeof(shm_rendezvous));
+  return token;
+}
+#endif
+}  // namespace
+
+constexpr size_t AllReduceSharedMemory::header_size;
+constexpr size_t AllReduceSharedMemory::slot_size;
+constexpr size_t AllReduceSharedMemory::default_timeout_seconds;
+
+AllReduceSharedMemory::AllReduceSharedMemory(
+    const size_t punique_id, const size_t ptotal, const size_t pnode, bool pquiet, size_t ptimeout_seconds)
+    : AllReduce(ptotal, pnode, pquiet)
+    , m_unique_id(punique_id)
+    , m_timeout_seconds(ptimeout_seconds)
+    , m_region(nullptr)
+    , m_region_size(0)
+{
+#ifdef _WIN32
+  THROW("Shared memory allreduce is not supported on Windows, use --span_server instead");
+#endif
+  if (total > MAX_NODES) THROW("Shared memory allreduce supports at most " << MAX_NODES << " nodes");
+  if (m_timeout_seconds == 0) THROW("Shared memory allreduce timeout must be positive");
+}
+
+AllReduceSharedMemory::~AllReduceSharedMemory()
+{
+#ifndef _WIN32
+  if (m_region != nullptr) { munmap(m_region, m_region_size); }
+#endif
+}
+
+void AllReduceSharedMemory::attach()
+{
+#ifndef _WIN32
+  const std::string rendezvous = rendezvous_name(m_unique_id);
+  m_region_size = header_size + total * slot_size;
+
+  std::string name;
+  int fd = -1;
+  if (node == 0)
+  {
+    // Remove the segments left behind by a run which crashed before every node attached.
+    int32_t creator = 0;
+    const uint64_t stale_token = read_rendezvous(rendezvous, creator);
+    if (stale_token != 0 && !process_alive(creator)) { shm_unlink(segment_name(m_unique_id, stale_token).c_str()); }
+    shm_unlink(rendezvous.c_str());
+    int rendezvous_fd = shm_open(rendezvous.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (rendezvous_fd < 0) THROWERRNO("shm_open(" << rendezvous << ")");
+    void* published = MAP_FAILED;
+    if (ftruncate(rendezvous_fd, sizeof(shm_rendezvous)) == 0)
+    { published = mmap(nullptr, sizeof(shm_rendezvous), PROT_READ | PROT_WRITE, MAP_SHARED, rendezvous_fd, 0); }
+    close(rendezvous_fd);
+    if (published == MAP_FAILED)
+    {
+      shm_unlink(rendezvous.c_str());
+      THROWERRNO("mmap(" << rendezvous << ")");
+    }
+
+    const uint64_t token = make_token();
+    name = segment_name(m_unique_id, token);
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(m_region_size)) != 0)
+    {
+      if (fd >= 0) { close(fd); }
+      munmap(published, sizeof(shm_rendezvous));
+      shm_unlink(name.c_str());
+      shm_unlink(rendezvous.c_str());
+      THROWERRNO("shm_open(" << name << ")");
+    }
+
+    auto* header = static_cast<shm_rendezvous*>(published);
+    header->creator.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+    header->token.store(token, std::memory_order_release);
+    munmap(published, sizeof(shm_rendezvous));
+  }
+  else
+  {
+    const auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+    while (true)
+    {
+      int32_t creator = 0;
+      const uint64_t token = read_rendezvous(rendezvous, creator);
+      // A rendezvous left behind by a node 0 which died is skipped, the current node 0 replaces it.
+      if (token != 0 && process_alive(creator))
+      {
+        name = segment_name(m_unique_id, token);
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+        struct stat info;
+        if (fd >= 0 && fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == m_region_size) { break; }
+        if (fd >= 0) { close(fd); }
+      }
+      if (std::chrono::steady_clock::now() > deadline)
+      { THROW("Timed out waiting for node 0 to create shared memory segment " << rendezvous); }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  void* region = mmap(nullptr, m_region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED)
+  {
+    if (node == 0)
+    {
+      shm_unlink(name.c_str());
+      shm_unlink(rendezvous.c_str());
+    }
+    THROWERRNO("mmap(" << name << ")");
+  }
+  m_region = region;
+  node_pids(m_region)[node].store(static_cast<int32_t>(getpid()), std::memory_order_release);
+
+  // Once everybody has mapped the segment the names are no longer needed, and unlinking them right away means nothing
+  // is left behind if a process dies later on. Node 0 also unlinks them if the others never show up.
+  try
+  {
+    barrier();
+  }
+  catch (...)
+  {
+    if (node == 0)
+    {
+      shm_unlink(name.c_str());
+      shm_unlink(rendezvous.c_str());
+    }
+    throw;
+  }
+  if (node == 0)
+  {
+    shm_unlink(name.c_str());
+    shm_unlink(rendezvous.c_str());
+  }
+#endif
+}
+
+void AllReduceSharedMemory::check_peers() const
+{
+#ifndef _WIN32
+  for (size_t i = 0; i < total; i++)
+  {
+    const int32_t pid = node_pids(m_region)[i].load(std::memory_order_acquire);
+    if (pid != 0 && !process_alive(pid)) THROW("Shared memory allreduce node " << i << " (pid " << pid << ") exited");
+  }
+#endif
+}
+
+void AllReduceSharedMemory::barrier()
+{
+  auto* header = static_cast<shm_header*>(m_region);
+  const uint32_t generation = header->generation.load(std::memory_order_acquire);
+  if (header->waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == total)
+  {
+    header->waiting.store(0, std::memory_order_relaxed);
+    header->generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  // Spin briefly since the other nodes are usually close behind, then back off to avoid starving them of a core.
+  const auto start = std::chrono::steady_clock::now();
+  auto next_check = start + PEER_CHECK_INTERVAL;
+  for (size_t spins = 0; header->generation.load(std::memory_order_acquire) == generation; spins++)
+  {
+    if (spins <= 1024) { continue; }
+    std::this_thread::yield();
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_check) { continue; }
+    next_check = now + PEER_CHECK_INTERVAL;
+    check_peers();
+    if (now - start > std::chrono::seconds(m_timeout_seconds))
+    { THROW("Timed out after " << m_timeout_seconds << "s waiting for the other shared memory allreduce nodes"); }
+  }
+}
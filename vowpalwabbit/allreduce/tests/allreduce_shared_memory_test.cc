@@ -0,0 +1,152 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/allreduce/allreduce.h"
+#include "vw/common/vw_exception.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#  include <signal.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace
+{
+void add_float(float& c1, const float& c2) { c1 += c2; }
+void add_size_t(size_t& c1, const size_t& c2) { c1 += c2; }
+
+// Separate test binaries may run concurrently, so derive the segment name from the pid.
+size_t test_unique_id(size_t offset) { return static_cast<size_t>(getpid()) * 16 + offset; }
+}  // namespace
+
+TEST(allreduce_shared_memory_tests, sum_spans_multiple_chunks)
+{
+  constexpr size_t total = 4;
+  // Not a multiple of the chunk size so the last chunk is partial.
+  const size_t n = 2 * AllReduceSharedMemory::slot_size / sizeof(float) + 123;
+  const size_t unique_id = test_unique_id(0);
+
+  std::vector<std::vector<float>> buffers(total);
+  std::vector<std::thread> nodes;
+  for (size_t node = 0; node < total; node++)
+  {
+    nodes.emplace_back([&buffers, n, node, unique_id]() {
+      AllReduceSharedMemory all_reduce(unique_id, total, node);
+      auto& buffer = buffers[node];
+      buffer.resize(n);
+      for (size_t i = 0; i < n; i++) { buffer[i] = static_cast<float>(node + 1) * static_cast<float>(i % 7); }
+      all_reduce.all_reduce<float, add_float>(buffer.data(), n);
+      // A second round reuses the already attached segment.
+      all_reduce.all_reduce<float, add_float>(buffer.data(), n);
+    });
+  }
+  for (auto& node : nodes) { node.join(); }
+
+  for (size_t node = 0; node < total; node++)
+  {
+    for (size_t i = 0; i < n; i++)
+    { ASSERT_FLOAT_EQ(buffers[node][i], static_cast<float>(total * 10 * (i % 7))) << "node " << node << " i " << i; }
+  }
+}
+
+TEST(allreduce_shared_memory_tests, more_nodes_than_elements)
+{
+  constexpr size_t total = 3;
+  const size_t unique_id = test_unique_id(1);
+
+  std::vector<size_t> results(total);
+  std::vector<std::thread> nodes;
+  for (size_t node = 0; node < total; node++)
+  {
+    nodes.emplace_back([&results, node, unique_id]() {
+      AllReduceSharedMemory all_reduce(unique_id, total, node);
+      size_t value = node + 1;
+      all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+      results[node] = value;
+    });
+  }
+  for (auto& node : nodes) { node.join(); }
+
+  for (auto result : results) { EXPECT_EQ(result, 6); }
+}
+
+TEST(allreduce_shared_memory_tests, segment_of_crashed_run_is_not_attached_to)
+{
+  const size_t unique_id = test_unique_id(2);
+
+  // A node 0 which dies while waiting for the others leaves its segments behind.
+  pid_t crashed = fork();
+  ASSERT_GE(crashed, 0);
+  if (crashed == 0)
+  {
+    AllReduceSharedMemory all_reduce(unique_id, 2, 0, true);
+    size_t value = 1;
+    all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+    _exit(0);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  kill(crashed, SIGKILL);
+  waitpid(crashed, nullptr, 0);
+
+  // Node 1 of the next run starts first and must wait for the new node 0 rather than attach to the old segment.
+  std::vector<size_t> results(2);
+  std::thread peer([&results, unique_id]() {
+    AllReduceSharedMemory all_reduce(unique_id, 2, 1, true);
+    size_t value = 2;
+    all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+    results[1] = value;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  AllReduceSharedMemory all_reduce(unique_id, 2, 0, true, 10);
+  size_t value = 1;
+  all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+  results[0] = value;
+  peer.join();
+
+  for (auto result : results) { EXPECT_EQ(result, 3); }
+}
+
+TEST(allreduce_shared_memory_tests, dead_peer_fails_the_wait)
+{
+  const size_t unique_id = test_unique_id(3);
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0)
+  {
+    // Takes part in the first round only, then exits.
+    AllReduceSharedMemory all_reduce(unique_id, 2, 1, true);
+    size_t value = 1;
+    all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+    _exit(value == 2 ? 0 : 1);
+  }
+
+  AllReduceSharedMemory all_reduce(unique_id, 2, 0, true);
+  size_t value = 1;
+  all_reduce.all_reduce<size_t, add_size_t>(&value, 1);
+  EXPECT_EQ(value, 2);
+  int status = 0;
+  waitpid(child, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // Fails as soon as the exit is noticed, long before the default timeout.
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW((all_reduce.all_reduce<size_t, add_size_t>(&value, 1)), VW::vw_exception);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST(allreduce_shared_memory_tests, missing_peer_times_out)
+{
+  AllReduceSharedMemory all_reduce(test_unique_id(4), 2, 0, true, 1);
+  size_t value = 1;
+  EXPECT_THROW((all_reduce.all_reduce<size_t, add_size_t>(&value, 1)), VW::vw_exception);
+}
+#endif
@@ -64,6 +64,7 @@ private:
   uint64_t _weight_mask;  // (stride*(1 << num_bits) -1)
   uint32_t _stride_shift;
   bool _seeded;  // whether the instance is sharing model state with others
+  size_t _mapped_bytes;  // non-zero if the weights are a file mapping owned by this instance
 #ifdef PRIVACY_ACTIVATION
   // struct to store the tag hash and if it is set or not
   struct tag_hash_info
@@ -76,6 +77,23 @@ private:
   tag_hash_info _tag_info;
 #endif
 
+  void release()
+  {
+    if (_begin == nullptr || _seeded) { return; }
+#ifndef _WIN32
+    if (_mapped_bytes != 0)
+    {
+      munmap(_begin, _mapped_bytes);
+      _mapped_bytes = 0;
+    }
+    else
+#endif
+    {
+      free(_begin);
+    }
+    _begin = nullptr;
+  }
+
 public:
   using iterator = dense_iterator<weight>;
   using const_iterator = dense_iterator<const weight>;
@@ -84,6 +102,7 @@ public:
       , _weight_mask((length << stride_shift) - 1)
       , _stride_shift(stride_shift)
       , _seeded(false)
+      , _mapped_bytes(0)
 #ifdef PRIVACY_ACTIVATION
       , _privacy_activation_threshold(0)
       , _feature_bitset(nullptr)
@@ -96,6 +115,7 @@ public:
       , _weight_mask(0)
       , _stride_shift(0)
       , _seeded(false)
+      , _mapped_bytes(0)
 #ifdef PRIVACY_ACTIVATION
       , _privacy_activation_threshold(0)
       , _feature_bitset(nullptr)
@@ -158,8 +178,9 @@ public:
 
   void shallow_copy(const dense_parameters& input)
   {
-    if (!_seeded) free(_begin);
+    release();
     _begin = input._begin;
+    _mapped_bytes = 0;
     _weight_mask = input._weight_mask;
     _stride_shift = input._stride_shift;
     _seeded = true;
@@ -234,6 +255,8 @@ public:
 
   uint64_t seeded() const { return _seeded; }
 
+  bool mapped() const { return _mapped_bytes != 0; }
+
   uint32_t stride() const { return 1 << _stride_shift; }
 
   uint32_t stride_shift() const { return _stride_shift; }
@@ -261,14 +284,37 @@ public:
     _begin = dest;
   }
 #  endif
-#endif
 
-  ~dense_parameters()
+  // Maps length << stride_shift weights stored at a page aligned offset of fd. The mapping is read only and shared, so
+  // every process mapping the same file uses a single physical copy of the weights and nothing is read up front.
+  void map_read_only(int fd, uint64_t offset, size_t length, uint32_t stride_shift)
   {
-    if (_begin != nullptr && !_seeded)  // don't free weight vector if it is shared with another instance
-    {
-      free(_begin);
-      _begin = nullptr;
-    }
+    map(fd, offset, length, stride_shift, PROT_READ, MAP_SHARED);
   }
+
+  // Same as map_read_only, but pages are copied on their first write so the weights can still be modified locally.
+  void map_copy_on_write(int fd, uint64_t offset, size_t length, uint32_t stride_shift)
+  {
+    map(fd, offset, length, stride_shift, PROT_READ | PROT_WRITE, MAP_PRIVATE);
+  }
+
+private:
+  void map(int fd, uint64_t offset, size_t length, uint32_t stride_shift, int protection, int flags)
+  {
+    size_t bytes = (length << stride_shift) * sizeof(weight);
+    void* mapped = mmap(nullptr, bytes, protection, flags, fd, static_cast<off_t>(offset));
+    if (mapped == MAP_FAILED) { THROWERRNO("mmap of " << bytes << " bytes of weights failed"); }
+    release();
+    _begin = static_cast<weight*>(mapped);
+    _weight_mask = (length << stride_shift) - 1;
+    _stride_shift = stride_shift;
+    _seeded = false;
+    _mapped_bytes = bytes;
+  }
+
+public:
+#endif
+
+  // don't free weight vector if it is shared with another instance
+  ~dense_parameters() { release(); }
 };
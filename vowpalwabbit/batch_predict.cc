@@ -0,0 +1,179 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "batch_predict.h"
+
+#include "example.h"
+#include "global_data.h"
+#include "learner.h"
+#include "memory.h"
+#include "parse_example.h"
+#include "vw.h"
+#include "vw/common/vw_exception.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace VW
+{
+struct batch_predictor::worker
+{
+  explicit worker(VW::workspace& all) : all(all) {}
+
+  // Parses the lines of a request into pooled examples, which stay valid until the next call.
+  VW::multi_ex& parse(const std::vector<std::string>& lines)
+  {
+    while (pool.size() < lines.size()) { pool.push_back(VW::make_unique<VW::example>()); }
+
+    request.clear();
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+      VW::example* ec = pool[i].get();
+      VW::empty_example(all, *ec);
+      VW::read_line(all, ec, lines[i].c_str());
+      VW::setup_example(all, ec);
+      request.push_back(ec);
+    }
+    return request;
+  }
+
+  VW::workspace& all;
+  std::vector<std::unique_ptr<VW::example>> pool;
+  VW::multi_ex request;
+};
+
+// Threads of the workspaces but the first, waiting for the batches handed out by run().
+struct batch_predictor::thread_pool
+{
+  std::mutex mutex;
+  std::condition_variable work_ready;
+  std::condition_variable work_done;
+  bool stop = false;
+
+  // The current batch, a new generation is started for each one.
+  uint64_t generation = 0;
+  const predict_range_fn* predict_range = nullptr;
+  size_t count = 0;
+  size_t num_shares = 0;
+  size_t pending = 0;
+  std::vector<std::exception_ptr> errors;
+
+  std::vector<std::thread> threads;
+
+  // Contiguous ranges of requests, share 0 is predicted on the calling thread.
+  void predict_share(worker& w, size_t t)
+  {
+    try
+    {
+      (*predict_range)(w, count * t / num_shares, count * (t + 1) / num_shares);
+    }
+    catch (...)
+    {
+      errors[t] = std::current_exception();
+    }
+  }
+};
+
+batch_predictor::batch_predictor(VW::workspace& all) : batch_predictor(std::vector<VW::workspace*>{&all}) {}
+
+batch_predictor::batch_predictor(std::vector<VW::workspace*> workspaces) : _pool(VW::make_unique<thread_pool>())
+{
+  if (workspaces.empty()) { THROW("batch_predictor requires at least one workspace"); }
+  for (auto* all : workspaces)
+  {
+    if (all == nullptr) { THROW("batch_predictor was given a null workspace"); }
+    if (!all->l->is_multiline()) { THROW("batch_predictor requires a multiline reduction stack, such as --cb_adf"); }
+    _workers.push_back(VW::make_unique<worker>(*all));
+  }
+  for (size_t t = 1; t < _workers.size(); t++) { _pool->threads.emplace_back(&batch_predictor::serve, this, t); }
+}
+
+batch_predictor::~batch_predictor()
+{
+  {
+    std::lock_guard<std::mutex> lock(_pool->mutex);
+    _pool->stop = true;
+  }
+  _pool->work_ready.notify_all();
+  for (auto& thread : _pool->threads) { thread.join(); }
+}
+
+void batch_predictor::serve(size_t t)
+{
+  auto& pool = *_pool;
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  while (true)
+  {
+    pool.work_ready.wait(lock, [&pool, seen] { return pool.stop || pool.generation != seen; });
+    if (pool.stop) { return; }
+    seen = pool.generation;
+    // Batches with fewer requests than workspaces leave the last ones idle.
+    if (t >= pool.num_shares) { continue; }
+
+    lock.unlock();
+    pool.predict_share(*_workers[t], t);
+    lock.lock();
+    if (--pool.pending == 0) { pool.work_done.notify_one(); }
+  }
+}
+
+void batch_predictor::run(size_t count, const predict_range_fn& predict_range)
+{
+  const size_t num_shares = std::min(_workers.size(), count);
+  if (num_shares <= 1)
+  {
+    if (count > 0) { predict_range(*_workers[0], 0, count); }
+    return;
+  }
+
+  auto& pool = *_pool;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.predict_range = &predict_range;
+    pool.count = count;
+    pool.num_shares = num_shares;
+    pool.pending = num_shares - 1;
+    pool.errors.assign(num_shares, nullptr);
+    ++pool.generation;
+  }
+  pool.work_ready.notify_all();
+
+  pool.predict_share(*_workers[0], 0);
+  {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.work_done.wait(lock, [&pool] { return pool.pending == 0; });
+  }
+
+  for (const auto& error : pool.errors)
+  {
+    if (error) { std::rethrow_exception(error); }
+  }
+}
+
+void batch_predictor::predict(
+    const std::vector<std::vector<std::string>>& requests, std::vector<ACTION_SCORE::action_scores>& predictions)
+{
+  predictions.resize(requests.size());
+  run(requests.size(), [&requests, &predictions](worker& w, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      if (requests[i].empty()) { THROW("batch_predictor request " << i << " has no examples"); }
+      auto& request = w.parse(requests[i]);
+      w.all.predict(request);
+      predictions[i] = request[0]->pred.a_s;
+    }
+  });
+}
+
+void batch_predictor::predict(VW::multi_ex* requests, size_t count)
+{
+  run(count, [requests](worker& w, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) { w.all.predict(requests[i]); }
+  });
+}
+}  // namespace VW
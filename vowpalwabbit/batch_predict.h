@@ -0,0 +1,63 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "action_score.h"
+#include "vw_fwd.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VW
+{
+// Predicts batches of multi line requests, such as contextual bandit decisions, in one call. Compared to calling
+// workspace::predict and finish_example for every request, examples are pooled and reused from batch to batch, and no
+// per request output, statistics or pool synchronization is done.
+//
+// Requests can be spread over several workspaces, one thread each. All of them must serve the same model with the same
+// options, for instance each initialized with -t and --shared_weights of the same file so the weights are mapped once
+// and shared read-only. The first workspace predicts on the calling thread, the others on threads started with the
+// predictor and kept for its lifetime. A workspace must not be used elsewhere while one of its batches is predicted.
+//
+// finish_example is never called on the examples of a batch. It writes predictions to -p files, updates the progress
+// and loss statistics of the shared data and returns the examples to the example pool of the workspace. Serving wants
+// none of these, and the examples parsed here are owned by the predictor rather than by the pool, which is why they
+// are cleared with empty_example and reused instead.
+class batch_predictor
+{
+public:
+  explicit batch_predictor(VW::workspace& all);
+  explicit batch_predictor(std::vector<VW::workspace*> workspaces);
+  ~batch_predictor();
+
+  batch_predictor(const batch_predictor&) = delete;
+  batch_predictor& operator=(const batch_predictor&) = delete;
+
+  // Predicts requests given as their lines in VW text format, the shared example first. The prediction of request i,
+  // examples[0]->pred.a_s of a workspace::predict call, is copied to predictions[i].
+  void predict(const std::vector<std::vector<std::string>>& requests,
+      std::vector<ACTION_SCORE::action_scores>& predictions);
+
+  // Predicts requests whose examples are owned by the caller, leaving each prediction on the first example of the
+  // request. finish_example is not called, so the examples can be refilled and predicted again. Examples read with
+  // VW::read_example must still be finished by the caller to return them to the pool.
+  void predict(VW::multi_ex* requests, size_t count);
+
+  size_t num_workspaces() const { return _workers.size(); }
+
+private:
+  struct worker;
+  struct thread_pool;
+  using predict_range_fn = std::function<void(worker&, size_t, size_t)>;
+
+  void run(size_t count, const predict_range_fn& predict_range);
+  void serve(size_t t);
+
+  std::vector<std::unique_ptr<worker>> _workers;
+  std::unique_ptr<thread_pool> _pool;
+};
+}  // namespace VW
@@ -11,6 +11,8 @@
 #include "text_utils.h"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <climits>
 #include <cstdint>
 
@@ -242,6 +244,158 @@ void free_flatten_example(flat_example* fec)
   }
 }
 
+namespace
+{
+struct namespace_capacities
+{
+  std::array<size_t, NUM_NAMESPACES> values;
+  std::array<size_t, NUM_NAMESPACES> indices;
+};
+
+using namespace_order = std::array<namespace_index, NUM_NAMESPACES>;
+
+// Lists the namespaces of ec.indices in order, followed by the other ones which have capacity. Returns their count.
+size_t packing_order(const example& ec, const namespace_capacities& capacities, namespace_order& order)
+{
+  std::array<bool, NUM_NAMESPACES> listed{};
+  size_t count = 0;
+  for (const auto ns : ec.indices)
+  {
+    if (listed[ns]) { continue; }
+    listed[ns] = true;
+    order[count++] = ns;
+  }
+  for (size_t ns = 0; ns < NUM_NAMESPACES; ns++)
+  {
+    if (!listed[ns] && (capacities.values[ns] > 0 || capacities.indices[ns] > 0))
+    { order[count++] = static_cast<namespace_index>(ns); }
+  }
+  return count;
+}
+
+// Moves the namespaces to one block of values and one block of indices taken from the arena of ec, with the given
+// capacity each, in packing order.
+void carve_packed(example& ec, const namespace_capacities& capacities)
+{
+  size_t total_values = 0;
+  size_t total_indices = 0;
+  for (size_t ns = 0; ns < NUM_NAMESPACES; ns++)
+  {
+    total_values += capacities.values[ns];
+    total_indices += capacities.indices[ns];
+  }
+  if (total_values + total_indices == 0) { return; }
+
+  auto* values = static_cast<feature_value*>(
+      ec.arena->allocate(total_values * sizeof(feature_value), alignof(feature_value)));
+  auto* indices = static_cast<feature_index*>(
+      ec.arena->allocate(total_indices * sizeof(feature_index), alignof(feature_index)));
+  namespace_order order;
+  const size_t count = packing_order(ec, capacities, order);
+  for (size_t i = 0; i < count; i++)
+  {
+    const namespace_index ns = order[i];
+    features& fs = ec.feature_space[ns];
+    if (capacities.values[ns] > 0)
+    {
+      fs.values.move_to_arena_storage(values, capacities.values[ns]);
+      values += capacities.values[ns];
+    }
+    if (capacities.indices[ns] > 0)
+    {
+      fs.indices.move_to_arena_storage(indices, capacities.indices[ns]);
+      indices += capacities.indices[ns];
+    }
+  }
+}
+}  // namespace
+
+void attach_example_arena(example& ec)
+{
+  if (ec.arena == nullptr) { ec.arena = VW::make_unique<example_arena>(); }
+  for (features& fs : ec.feature_space)
+  {
+    fs.values.use_arena(ec.arena.get());
+    fs.indices.use_arena(ec.arena.get());
+  }
+}
+
+void reset_example_arena(example& ec)
+{
+  constexpr size_t SHRINK_PERIOD = 1024;
+  example_arena* arena = ec.arena.get();
+  assert(arena != nullptr);
+  const bool shrink = (arena->resets() + 1) % SHRINK_PERIOD == 0;
+
+  namespace_capacities capacities;
+  size_t keep_bytes = 0;
+  for (size_t ns = 0; ns < NUM_NAMESPACES; ns++)
+  {
+    // Arrays swapped in from another example keep their own storage.
+    features& fs = ec.feature_space[ns];
+    capacities.values[ns] = 0;
+    capacities.indices[ns] = 0;
+    if (fs.values.arena() == arena)
+    {
+      capacities.values[ns] = shrink ? fs.values.size() : fs.values.capacity();
+      fs.values.release_arena_storage();
+    }
+    if (fs.indices.arena() == arena)
+    {
+      capacities.indices[ns] = shrink ? fs.indices.size() : fs.indices.capacity();
+      fs.indices.release_arena_storage();
+    }
+    keep_bytes += capacities.values[ns] * sizeof(feature_value) + capacities.indices[ns] * sizeof(feature_index);
+  }
+  keep_bytes += alignof(feature_index);
+
+  if (shrink) { arena->reset(keep_bytes); }
+  else
+  {
+    arena->reset();
+  }
+
+  // ec.indices still lists the namespaces of the example just emptied, which the next one most likely uses as well.
+  carve_packed(ec, capacities);
+}
+
+void compact_example_features(example& ec)
+{
+  example_arena* arena = ec.arena.get();
+  assert(arena != nullptr);
+
+  namespace_capacities capacities;
+  for (size_t ns = 0; ns < NUM_NAMESPACES; ns++)
+  {
+    const features& fs = ec.feature_space[ns];
+    capacities.values[ns] = fs.values.arena() == arena ? fs.values.capacity() : 0;
+    capacities.indices[ns] = fs.indices.arena() == arena ? fs.indices.capacity() : 0;
+  }
+
+  // Examples shaped like the previous one were parsed into the packed layout carved on reset already.
+  const feature_value* next_value = nullptr;
+  const feature_index* next_index = nullptr;
+  bool packed = true;
+  namespace_order order;
+  const size_t count = packing_order(ec, capacities, order);
+  for (size_t i = 0; i < count; i++)
+  {
+    const namespace_index ns = order[i];
+    const features& fs = ec.feature_space[ns];
+    if (capacities.values[ns] > 0)
+    {
+      packed &= next_value == nullptr || fs.values.begin() == next_value;
+      next_value = fs.values.begin() + capacities.values[ns];
+    }
+    if (capacities.indices[ns] > 0)
+    {
+      packed &= next_index == nullptr || fs.indices.begin() == next_index;
+      next_index = fs.indices.begin() + capacities.indices[ns];
+    }
+  }
+  if (!packed) { carve_packed(ec, capacities); }
+}
+
 example* alloc_examples(size_t count)
 {
   example* ec = calloc_or_throw<example>(count);
@@ -13,6 +13,7 @@
 #include "constant.h"
 #include "cost_sensitive.h"
 #include "decision_scores.h"
+#include "example_arena.h"
 #include "example_predict.h"
 #include "feature_group.h"
 #include "multiclass.h"
@@ -24,11 +25,13 @@
 #include "v_array.h"
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace VW
 {
 struct workspace;
+struct shared_feature_cache;
 }
 namespace VW
 {
@@ -113,6 +116,10 @@ struct example : public example_predict  // core example datatype.
   float confidence = 0.f;
   features* passthrough =
       nullptr;  // if a higher-up reduction wants access to internal state of lower-down reductions, they go here
+  // set by shared_feature_merger while predicting on a multi_ex, so that gd scores the shared features only once
+  shared_feature_cache* shared_features = nullptr;
+  // set with --example_arena, holds the values and indices of feature_space until the example is emptied
+  std::unique_ptr<example_arena> arena;
 
   bool test_only = false;
   bool end_pass = false;  // special example indicating end of pass.
@@ -160,6 +167,16 @@ flat_example* flatten_example(VW::workspace& all, example* ec);
 flat_example* flatten_sort_example(VW::workspace& all, example* ec);
 void free_flatten_example(flat_example* fec);
 
+// Makes the values and indices of every namespace of ec come from an arena owned by ec.
+void attach_example_arena(example& ec);
+// Drops the features of every namespace of ec at once by resetting its arena. The namespaces get back the capacity
+// they had, every so often only what they used, packed as by compact_example_features.
+void reset_example_arena(example& ec);
+// Packs the features of ec, which must have an arena, into one contiguous array of values and one of indices, where
+// the namespaces follow the order of ec.indices. Does not copy anything when they are packed already, which is the
+// case when ec has the namespaces of the example it held before and no more features in any of them.
+void compact_example_features(example& ec);
+
 inline bool example_is_newline(const example& ec) { return ec.is_newline; }
 
 inline bool valid_ns(char c) { return !(c == '|' || c == ':'); }
@@ -0,0 +1,109 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "example_arena.h"
+
+#include "vw/common/vw_exception.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+constexpr size_t MIN_CHUNK_SIZE = 4096;
+
+size_t align_up(size_t offset, const char* base, size_t alignment)
+{
+  const auto address = reinterpret_cast<uintptr_t>(base) + offset;
+  return offset + ((alignment - address % alignment) % alignment);
+}
+}  // namespace
+
+namespace VW
+{
+example_arena::~example_arena() { release_chunks(); }
+
+void* example_arena::allocate(size_t bytes, size_t alignment)
+{
+  if (!_chunks.empty())
+  {
+    const auto& last = _chunks.back();
+    const size_t start = align_up(_offset, last.data, alignment);
+    if (start + bytes <= last.size)
+    {
+      _offset = start + bytes;
+      return last.data + start;
+    }
+  }
+
+  add_chunk(bytes + alignment);
+  const auto& last = _chunks.back();
+  const size_t start = align_up(0, last.data, alignment);
+  _offset = start + bytes;
+  return last.data + start;
+}
+
+bool example_arena::try_extend(void* ptr, size_t old_bytes, size_t new_bytes)
+{
+  if (_chunks.empty()) { return false; }
+  const auto& last = _chunks.back();
+  const auto* p = static_cast<const char*>(ptr);
+  if (p + old_bytes != last.data + _offset) { return false; }
+
+  const auto start = static_cast<size_t>(p - last.data);
+  if (start + new_bytes > last.size) { return false; }
+  _offset = start + new_bytes;
+  return true;
+}
+
+void example_arena::reset()
+{
+  _resets++;
+  _offset = 0;
+  if (_chunks.size() <= 1) { return; }
+
+  const size_t total = _capacity;
+  release_chunks();
+  add_chunk(total);
+}
+
+void example_arena::reset(size_t keep_bytes)
+{
+  keep_bytes = std::max(keep_bytes, MIN_CHUNK_SIZE);
+  if (_capacity <= 2 * keep_bytes)
+  {
+    reset();
+    return;
+  }
+
+  _resets++;
+  _offset = 0;
+  release_chunks();
+  add_chunk(keep_bytes);
+}
+
+size_t example_arena::used() const { return _chunks.empty() ? 0 : _full_bytes + _offset; }
+
+void example_arena::add_chunk(size_t min_bytes)
+{
+  // Chunks at least double, so an example needs a logarithmic number of them before the next reset merges them.
+  const size_t size = std::max({min_bytes, _capacity, MIN_CHUNK_SIZE});
+  auto* data = static_cast<char*>(std::malloc(size));
+  if (data == nullptr) { THROW("example_arena: allocation of " << size << " bytes failed. Out of memory?"); }
+
+  if (!_chunks.empty()) { _full_bytes += _chunks.back().size; }
+  _chunks.push_back({data, size});
+  _capacity += size;
+  _offset = 0;
+}
+
+void example_arena::release_chunks()
+{
+  for (auto& c : _chunks) { std::free(c.data); }
+  _chunks.clear();
+  _capacity = 0;
+  _full_bytes = 0;
+}
+}  // namespace VW
@@ -0,0 +1,58 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "v_array.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace VW
+{
+// A bump allocator holding the feature values and indices of an example, enabled with --example_arena.
+//
+// Allocations are never freed one by one. The arena is reset at once when its example is emptied, and the chunks it
+// grew to are then merged into one, so that once examples of a given size were seen they are parsed without a single
+// allocation.
+class example_arena final : public v_array_arena
+{
+public:
+  example_arena() = default;
+  ~example_arena();
+
+  example_arena(const example_arena&) = delete;
+  example_arena& operator=(const example_arena&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment) override;
+
+  // Grows the allocation at ptr to new_bytes in place, which is only possible for the latest allocation.
+  bool try_extend(void* ptr, size_t old_bytes, size_t new_bytes) override;
+
+  // Invalidates every allocation.
+  void reset();
+  // Same as reset, but also gives memory back to the system if more than twice keep_bytes is held.
+  void reset(size_t keep_bytes);
+
+  size_t capacity() const { return _capacity; }
+  size_t used() const;
+  size_t resets() const { return _resets; }
+
+private:
+  struct chunk
+  {
+    char* data;
+    size_t size;
+  };
+
+  void add_chunk(size_t min_bytes);
+  void release_chunks();
+
+  std::vector<chunk> _chunks;
+  size_t _offset = 0;      // first free byte of the last chunk
+  size_t _capacity = 0;    // sum of the chunk sizes
+  size_t _full_bytes = 0;  // sum of the sizes of all chunks but the last
+  size_t _resets = 0;
+};
+}  // namespace VW
@@ -4,6 +4,7 @@
 
 // get the error code defined in master
 #include "explore.h"
+#include "explore_simd.h"
 
 #include <cstdint>
 #include <stdexcept>
@@ -89,6 +90,8 @@ namespace exploration
 
     if (pmf_last - pmf_first == 0) return E_EXPLORATION_BAD_RANGE;
 
+    if (simd::try_generate_softmax(lambda, scores_first, pmf_first, pmf_last)) return S_EXPLORATION_OK;
+
     float norm = 0.;
     float max_score = lambda > 0 ? *std::max_element(scores_first, scores_last)
                                  : *std::min_element(scores_first, scores_last);
@@ -179,6 +182,9 @@ namespace exploration
     }
 
     minimum_uniform /= num_actions;
+    if (simd::try_enforce_minimum_probability(minimum_uniform, update_zero_elements, pmf_first, pmf_last))
+      return S_EXPLORATION_OK;
+
     float touched_mass = 0.;
     float untouched_mass = 0.;
     uint16_t num_actions_touched = 0;
@@ -239,11 +245,14 @@ namespace exploration
     // Create a discrete_distribution based on the returned weights. This class handles the
     // case where the sum of the weights is < or > 1, by normalizing agains the sum.
     float total = 0.f;
-    for (It pmf = pmf_first; pmf != pmf_last; ++pmf)
+    if (!simd::try_clamp_and_sum(pmf_first, pmf_last, total))
     {
-      if (*pmf < 0) *pmf = 0;
+      for (It pmf = pmf_first; pmf != pmf_last; ++pmf)
+      {
+        if (*pmf < 0) *pmf = 0;
 
-      total += *pmf;
+        total += *pmf;
+      }
     }
 
     // assume the first is the best
@@ -258,6 +267,8 @@ namespace exploration
     if (draw > total)  // make very sure that draw can not be greater than total.
       draw = total;
 
+    if (simd::try_sample_and_normalize(draw, total, pmf_first, pmf_last, chosen_index)) return S_EXPLORATION_OK;
+
     bool index_found = false;  // found chosen action
     float sum = 0.f;
     uint32_t i = 0;
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(VW_NO_INLINE_SIMD) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64))
+#  define EXPLORE_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace exploration
+{
+  // Iterators which point to floats laid out at a fixed distance from each other can opt in to the vectorized
+  // kernels by specializing this trait. stride is the distance in floats, and &*it must be the address of the
+  // float the iterator refers to. Plain float arrays (stride 1) and the floats of {uint32_t, float} pairs (stride 2)
+  // are vectorized.
+  template <typename It>
+  struct strided_floats
+  {
+    static constexpr bool value = false;
+    static constexpr size_t stride = 0;
+  };
+
+  template <>
+  struct strided_floats<float*>
+  {
+    static constexpr bool value = true;
+    static constexpr size_t stride = 1;
+  };
+
+  template <>
+  struct strided_floats<const float*>
+  {
+    static constexpr bool value = true;
+    static constexpr size_t stride = 1;
+  };
+
+  namespace simd
+  {
+#ifdef EXPLORE_SIMD_SSE2
+  template <typename It>
+  struct is_vectorized
+  {
+    static constexpr bool value =
+        strided_floats<It>::value && (strided_floats<It>::stride == 1 || strided_floats<It>::stride == 2);
+  };
+
+  template <size_t Stride>
+  struct lanes;
+
+  template <>
+  struct lanes<1>
+  {
+    static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+  };
+
+  // The second float of {other, float} pairs, such as the score of an action_score. p points to the first float of a
+  // group of four, so the pairs start one float before it. The other halves are written back as they were.
+  template <>
+  struct lanes<2>
+  {
+    static __m128 load(const float* p)
+    {
+      return _mm_shuffle_ps(_mm_loadu_ps(p - 1), _mm_loadu_ps(p + 3), _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    static void store(float* p, __m128 v)
+    {
+      __m128 other = _mm_shuffle_ps(_mm_loadu_ps(p - 1), _mm_loadu_ps(p + 3), _MM_SHUFFLE(2, 0, 2, 0));
+      _mm_storeu_ps(p - 1, _mm_unpacklo_ps(other, v));
+      _mm_storeu_ps(p + 3, _mm_unpackhi_ps(other, v));
+    }
+  };
+
+  inline float horizontal_max(__m128 v)
+  {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+  }
+
+  inline float horizontal_min(__m128 v)
+  {
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+  }
+
+  // Adds the lanes of v to sum one after the other, in the order the scalar loops add the elements. Together with lanes
+  // which are masked to 0, which leave the sum as it is, this keeps the sums and so the pmfs identical to the scalar
+  // loops, and with them the actions sampled for a given seed.
+  inline float sequential_sum(float sum, __m128 v)
+  {
+    float values[4];
+    _mm_storeu_ps(values, v);
+    return sum + values[0] + values[1] + values[2] + values[3];
+  }
+
+  // The last (count % 4) elements go through a padded copy.
+  template <size_t Stride>
+  inline __m128 load_tail(const float* p, size_t count, float pad)
+  {
+    float tail[4] = {pad, pad, pad, pad};
+    for (size_t i = 0; i < count; ++i) tail[i] = p[i * Stride];
+    return _mm_loadu_ps(tail);
+  }
+
+  template <size_t InStride, size_t OutStride>
+  void softmax(float lambda, const float* scores, float* pmf, size_t num_actions)
+  {
+    const size_t num_vectorized = num_actions & ~static_cast<size_t>(3);
+    const size_t num_tail = num_actions - num_vectorized;
+    const float* scores_tail = scores + num_vectorized * InStride;
+    float* pmf_tail = pmf + num_vectorized * OutStride;
+
+    float max_score;
+    if (lambda > 0)
+    {
+      __m128 m = load_tail<InStride>(scores_tail, num_tail, -INFINITY);
+      for (size_t i = 0; i < num_vectorized; i += 4) m = _mm_max_ps(m, lanes<InStride>::load(scores + i * InStride));
+      max_score = horizontal_max(m);
+    }
+    else
+    {
+      __m128 m = load_tail<InStride>(scores_tail, num_tail, INFINITY);
+      for (size_t i = 0; i < num_vectorized; i += 4) m = _mm_min_ps(m, lanes<InStride>::load(scores + i * InStride));
+      max_score = horizontal_min(m);
+    }
+
+    // The exponentials and their sum stay scalar: a polynomial exp or a lane wise sum would change the pmf in its last
+    // bits, and with it the action sampled for a given seed.
+    float norm = 0.f;
+    for (size_t i = 0; i < num_actions; ++i)
+    {
+      float prob = std::exp(lambda * (scores[i * InStride] - max_score));
+      norm += prob;
+      pmf[i * OutStride] = prob;
+    }
+
+    const __m128 n = _mm_set1_ps(norm);
+    for (size_t i = 0; i < num_vectorized; i += 4)
+    { lanes<OutStride>::store(pmf + i * OutStride, _mm_div_ps(lanes<OutStride>::load(pmf + i * OutStride), n)); }
+    for (size_t i = 0; i < num_tail; ++i) pmf_tail[i * OutStride] /= norm;
+  }
+
+  // The part of enforce_minimum_probability which is not uniform exploration, see explore_internal.h.
+  template <size_t Stride>
+  void enforce_minimum_probability(float minimum_uniform, bool update_zero_elements, float* pmf, size_t num_actions)
+  {
+    const size_t num_vectorized = num_actions & ~static_cast<size_t>(3);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 update_zero = update_zero_elements ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+
+    // Whether an element is raised to a minimum of mu.
+    auto touched = [&](__m128 prob, __m128 mu) {
+      __m128 eligible = _mm_or_ps(_mm_cmpgt_ps(prob, zero), _mm_and_ps(_mm_cmpeq_ps(prob, zero), update_zero));
+      return _mm_and_ps(eligible, _mm_cmple_ps(prob, mu));
+    };
+    auto blend = [](__m128 mask, __m128 if_set, __m128 if_unset) {
+      return _mm_or_ps(_mm_and_ps(mask, if_set), _mm_andnot_ps(mask, if_unset));
+    };
+
+    const __m128 mu = _mm_set1_ps(minimum_uniform);
+    float touched_sum = 0.f;
+    float untouched_sum = 0.f;
+    int num_actions_touched = 0;
+    for (size_t i = 0; i < num_vectorized; i += 4)
+    {
+      float* p = pmf + i * Stride;
+      __m128 prob = lanes<Stride>::load(p);
+      __m128 mask = touched(prob, mu);
+      touched_sum = sequential_sum(touched_sum, _mm_and_ps(mask, mu));
+      untouched_sum = sequential_sum(untouched_sum, _mm_andnot_ps(mask, prob));
+      const int bits = _mm_movemask_ps(mask);
+      num_actions_touched += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+      lanes<Stride>::store(p, blend(mask, mu, prob));
+    }
+    for (size_t i = num_vectorized; i < num_actions; ++i)
+    {
+      float& prob = pmf[i * Stride];
+      if ((prob > 0 || (prob == 0 && update_zero_elements)) && prob <= minimum_uniform)
+      {
+        touched_sum += minimum_uniform;
+        prob = minimum_uniform;
+        ++num_actions_touched;
+      }
+      else
+        untouched_sum += prob;
+    }
+
+    if (touched_sum <= 0.) return;
+
+    if (touched_sum > 0.999)
+    {
+      minimum_uniform = (1.f - untouched_sum) / static_cast<float>(static_cast<uint16_t>(num_actions_touched));
+      const __m128 raised = _mm_set1_ps(minimum_uniform);
+      for (size_t i = 0; i < num_vectorized; i += 4)
+      {
+        float* p = pmf + i * Stride;
+        __m128 prob = lanes<Stride>::load(p);
+        lanes<Stride>::store(p, blend(touched(prob, raised), raised, prob));
+      }
+      for (size_t i = num_vectorized; i < num_actions; ++i)
+      {
+        float& prob = pmf[i * Stride];
+        if ((prob > 0 || (prob == 0 && update_zero_elements)) && prob <= minimum_uniform) prob = minimum_uniform;
+      }
+    }
+    else
+    {
+      const float ratio = (1.f - touched_sum) / untouched_sum;
+      const __m128 r = _mm_set1_ps(ratio);
+      for (size_t i = 0; i < num_vectorized; i += 4)
+      {
+        float* p = pmf + i * Stride;
+        __m128 prob = lanes<Stride>::load(p);
+        lanes<Stride>::store(p, blend(_mm_cmpgt_ps(prob, mu), _mm_mul_ps(prob, r), prob));
+      }
+      for (size_t i = num_vectorized; i < num_actions; ++i)
+        if (pmf[i * Stride] > minimum_uniform) pmf[i * Stride] *= ratio;
+    }
+  }
+
+  // Clamps negative elements to 0 and returns the total.
+  template <size_t Stride>
+  float clamp_and_sum(float* pmf, size_t num_actions)
+  {
+    const size_t num_vectorized = num_actions & ~static_cast<size_t>(3);
+    const __m128 zero = _mm_setzero_ps();
+    float sum = 0.f;
+    for (size_t i = 0; i < num_vectorized; i += 4)
+    {
+      float* p = pmf + i * Stride;
+      __m128 prob = lanes<Stride>::load(p);
+      prob = _mm_andnot_ps(_mm_cmplt_ps(prob, zero), prob);
+      sum = sequential_sum(sum, prob);
+      lanes<Stride>::store(p, prob);
+    }
+    for (size_t i = num_vectorized; i < num_actions; ++i)
+    {
+      float& prob = pmf[i * Stride];
+      if (prob < 0) prob = 0;
+      sum += prob;
+    }
+    return sum;
+  }
+
+  // Finds the first element whose prefix sum exceeds draw while normalizing by total. The prefix sums are added up one
+  // element after the other as in the scalar loop, an in register scan would round differently and could pick the
+  // neighbour of the scalar choice. Once found the rest is only normalized. Returns num_actions when no prefix sum
+  // exceeds draw.
+  template <size_t Stride>
+  size_t sample_and_normalize(float draw, float total, float* pmf, size_t num_actions)
+  {
+    const size_t num_vectorized = num_actions & ~static_cast<size_t>(3);
+    const __m128 t = _mm_set1_ps(total);
+    size_t chosen = num_actions;
+    float sum = 0.f;
+    for (size_t i = 0; i < num_vectorized; i += 4)
+    {
+      float* p = pmf + i * Stride;
+      __m128 prob = lanes<Stride>::load(p);
+      if (chosen == num_actions)
+      {
+        float values[4];
+        _mm_storeu_ps(values, prob);
+        for (size_t lane = 0; lane < 4 && chosen == num_actions; ++lane)
+        {
+          sum += values[lane];
+          if (sum > draw) chosen = i + lane;
+        }
+      }
+      lanes<Stride>::store(p, _mm_div_ps(prob, t));
+    }
+    for (size_t i = num_vectorized; i < num_actions; ++i)
+    {
+      float& prob = pmf[i * Stride];
+      sum += prob;
+      if (chosen == num_actions && sum > draw) chosen = i;
+      prob /= total;
+    }
+    return chosen;
+  }
+
+  template <typename InputIt, typename OutputIt>
+  bool try_generate_softmax(float lambda, InputIt scores_first, OutputIt pmf_first, OutputIt pmf_last, std::true_type)
+  {
+    softmax<strided_floats<InputIt>::stride, strided_floats<OutputIt>::stride>(
+        lambda, &*scores_first, &*pmf_first, pmf_last - pmf_first);
+    return true;
+  }
+
+  template <typename It>
+  bool try_enforce_minimum_probability(
+      float minimum_uniform, bool update_zero_elements, It pmf_first, It pmf_last, std::true_type)
+  {
+    enforce_minimum_probability<strided_floats<It>::stride>(
+        minimum_uniform, update_zero_elements, &*pmf_first, pmf_last - pmf_first);
+    return true;
+  }
+
+  template <typename It>
+  bool try_clamp_and_sum(It pmf_first, It pmf_last, float& total, std::true_type)
+  {
+    total = clamp_and_sum<strided_floats<It>::stride>(&*pmf_first, pmf_last - pmf_first);
+    return true;
+  }
+
+  template <typename It>
+  bool try_sample_and_normalize(
+      float draw, float total, It pmf_first, It pmf_last, uint32_t& chosen_index, std::true_type)
+  {
+    const size_t num_actions = pmf_last - pmf_first;
+    const size_t chosen = sample_and_normalize<strided_floats<It>::stride>(draw, total, &*pmf_first, num_actions);
+    chosen_index = static_cast<uint32_t>(chosen == num_actions ? num_actions - 1 : chosen);
+    return true;
+  }
+#else
+  template <typename It>
+  struct is_vectorized
+  {
+    static constexpr bool value = false;
+  };
+#endif
+
+  // Fallbacks for iterators without vectorized kernels, the callers then run their scalar loops.
+  template <typename InputIt, typename OutputIt>
+  bool try_generate_softmax(float, InputIt, OutputIt, OutputIt, std::false_type)
+  {
+    return false;
+  }
+
+  template <typename It>
+  bool try_enforce_minimum_probability(float, bool, It, It, std::false_type)
+  {
+    return false;
+  }
+
+  template <typename It>
+  bool try_clamp_and_sum(It, It, float&, std::false_type)
+  {
+    return false;
+  }
+
+  template <typename It>
+  bool try_sample_and_normalize(float, float, It, It, uint32_t&, std::false_type)
+  {
+    return false;
+  }
+
+  template <typename InputIt, typename OutputIt>
+  bool try_generate_softmax(float lambda, InputIt scores_first, OutputIt pmf_first, OutputIt pmf_last)
+  {
+    return try_generate_softmax(lambda, scores_first, pmf_first, pmf_last,
+        std::integral_constant<bool, is_vectorized<InputIt>::value && is_vectorized<OutputIt>::value>());
+  }
+
+  template <typename It>
+  bool try_enforce_minimum_probability(float minimum_uniform, bool update_zero_elements, It pmf_first, It pmf_last)
+  {
+    return try_enforce_minimum_probability(minimum_uniform, update_zero_elements, pmf_first, pmf_last,
+        std::integral_constant<bool, is_vectorized<It>::value>());
+  }
+
+  template <typename It>
+  bool try_clamp_and_sum(It pmf_first, It pmf_last, float& total)
+  {
+    return try_clamp_and_sum(pmf_first, pmf_last, total, std::integral_constant<bool, is_vectorized<It>::value>());
+  }
+
+  template <typename It>
+  bool try_sample_and_normalize(float draw, float total, It pmf_first, It pmf_last, uint32_t& chosen_index)
+  {
+    return try_sample_and_normalize(
+        draw, total, pmf_first, pmf_last, chosen_index, std::integral_constant<bool, is_vectorized<It>::value>());
+  }
+  }  // namespace simd
+}  // namespace exploration
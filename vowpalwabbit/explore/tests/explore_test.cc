@@ -4,11 +4,13 @@
 
 #include "vw/explore/explore.h"
 
+#include "action_score.h"
 #include "reductions/cb/cb_explore_pdf.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <vector>
 
 using namespace VW::continuous_actions;
@@ -364,3 +366,68 @@ TEST(explore_tests, sampling_rank_negative_pdf)
   EXPECT_THAT(expected_pdf, Pointwise(FloatNear(1e-2f), pdf));
   EXPECT_THAT(0, chosen_index);
 }
+
+// Pointers and action_scores go through the vectorized kernels when they are available, std::vector iterators always
+// take the scalar loops. The kernels must give the same pmfs bit for bit, so that a seed samples the same action either
+// way. Sizes cover the remainders of the kernels' groups of four.
+TEST(explore_tests, vectorized_kernels_match_scalar)
+{
+  for (size_t num_actions = 1; num_actions <= 37; ++num_actions)
+  {
+    for (float lambda : {-2.f, 0.5f, 30.f})
+    {
+      std::vector<float> scores(num_actions);
+      for (size_t i = 0; i < num_actions; ++i) { scores[i] = std::cos(2.3f * static_cast<float>(i)); }
+      std::vector<float> expected(num_actions);
+      std::vector<float> pmf(num_actions);
+      exploration::generate_softmax(lambda, scores.begin(), scores.end(), expected.begin(), expected.end());
+      exploration::generate_softmax(lambda, scores.data(), scores.data() + num_actions, pmf.data(),
+          pmf.data() + num_actions);
+      EXPECT_EQ(pmf, expected);
+    }
+
+    std::vector<float> scores(num_actions);
+    ACTION_SCORE::action_scores a_s;
+    for (size_t i = 0; i < num_actions; ++i)
+    {
+      scores[i] = 3.f * std::sin(1.7f * static_cast<float>(i));
+      a_s.push_back({static_cast<uint32_t>(2 * i + 1), scores[i]});
+    }
+
+    std::vector<float> expected(num_actions);
+    std::vector<float> pmf(num_actions);
+    EXPECT_EQ(S_EXPLORATION_OK,
+        exploration::generate_softmax(-2.f, scores.begin(), scores.end(), expected.begin(), expected.end()));
+    EXPECT_EQ(S_EXPLORATION_OK,
+        exploration::generate_softmax(-2.f, scores.data(), scores.data() + num_actions, pmf.data(),
+            pmf.data() + num_actions));
+    EXPECT_EQ(S_EXPLORATION_OK,
+        exploration::generate_softmax(-2.f, begin_scores(a_s), end_scores(a_s), begin_scores(a_s), end_scores(a_s)));
+    EXPECT_EQ(pmf, expected);
+    for (size_t i = 0; i < num_actions; ++i)
+    {
+      EXPECT_EQ(a_s[i].action, 2 * i + 1);
+      EXPECT_EQ(a_s[i].score, expected[i]);
+    }
+
+    exploration::enforce_minimum_probability(0.3f, true, expected.begin(), expected.end());
+    exploration::enforce_minimum_probability(0.3f, true, pmf.data(), pmf.data() + num_actions);
+    exploration::enforce_minimum_probability(0.3f, true, begin_scores(a_s), end_scores(a_s));
+    EXPECT_EQ(pmf, expected);
+    for (size_t i = 0; i < num_actions; ++i) { EXPECT_EQ(a_s[i].score, expected[i]); }
+
+    for (uint64_t seed = 1; seed < 50; ++seed)
+    {
+      std::vector<float> scalar = expected;
+      std::vector<float> vectorized = expected;
+      scalar[0] = vectorized[0] = -1.f;
+      uint32_t scalar_index;
+      uint32_t vectorized_index;
+      exploration::sample_after_normalizing(seed * 0x9e3779b97f4a7c15ULL, scalar.begin(), scalar.end(), scalar_index);
+      exploration::sample_after_normalizing(
+          seed * 0x9e3779b97f4a7c15ULL, vectorized.data(), vectorized.data() + num_actions, vectorized_index);
+      EXPECT_EQ(scalar_index, vectorized_index);
+      EXPECT_EQ(vectorized, scalar);
+    }
+  }
+}
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -52,6 +53,157 @@ inline std::string to_string(const audit_strings& ai)
   if (!ai.str_value.empty()) { ss << '^' << ai.str_value; }
   return ss.str();
 }
+
+// The audit strings of a feature as ranges of the input it was parsed from.
+struct lazy_audit_strings
+{
+  uint32_t ns_begin;
+  uint32_t ns_size;
+  uint32_t name_begin;
+  uint32_t name_size;
+  uint32_t str_value_begin;
+  uint32_t str_value_size;
+
+  audit_strings resolve(const std::string& source) const
+  {
+    return audit_strings(source.substr(ns_begin, ns_size), source.substr(name_begin, name_size),
+        source.substr(str_value_begin, str_value_size));
+  }
+};
+
+// The audit strings of a features object, which can be added as references into the input of the parser.
+//
+// References are only built into audit_strings when the list is read or changed through anything but size(), all of
+// them at once, or one at a time with get(). A copy of the input is shared by the lists referring to it.
+class audit_strings_list
+{
+public:
+  using value_type = audit_strings;
+  using iterator = std::vector<audit_strings>::iterator;
+  using const_iterator = std::vector<audit_strings>::const_iterator;
+
+  size_t size() const { return _resolved.size() + _lazy.size(); }
+  bool empty() const { return _resolved.empty() && _lazy.empty(); }
+
+  void clear()
+  {
+    _resolved.clear();
+    _lazy.clear();
+    _source.reset();
+  }
+
+  void reserve(size_t count)
+  {
+    if (_lazy.empty()) { _resolved.reserve(count); }
+  }
+
+  void resize(size_t count)
+  {
+    resolve();
+    _resolved.resize(count);
+  }
+
+  void push_back(const audit_strings& strings)
+  {
+    resolve();
+    _resolved.push_back(strings);
+  }
+
+  void push_back(audit_strings&& strings)
+  {
+    resolve();
+    _resolved.push_back(std::move(strings));
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args)
+  {
+    resolve();
+    _resolved.emplace_back(std::forward<Args>(args)...);
+  }
+
+  void push_back_lazy(const std::shared_ptr<const std::string>& source, const lazy_audit_strings& strings)
+  {
+    if (source != _source)
+    {
+      resolve();
+      _source = source;
+    }
+    _lazy.push_back(strings);
+  }
+
+  // Builds the strings at index i only.
+  audit_strings get(size_t i) const
+  {
+    return i < _resolved.size() ? _resolved[i] : _lazy[i - _resolved.size()].resolve(*_source);
+  }
+
+  audit_strings& operator[](size_t i)
+  {
+    resolve();
+    return _resolved[i];
+  }
+  const audit_strings& operator[](size_t i) const
+  {
+    resolve();
+    return _resolved[i];
+  }
+
+  audit_strings* data()
+  {
+    resolve();
+    return _resolved.data();
+  }
+  const audit_strings* data() const
+  {
+    resolve();
+    return _resolved.data();
+  }
+
+  iterator begin()
+  {
+    resolve();
+    return _resolved.begin();
+  }
+  iterator end()
+  {
+    resolve();
+    return _resolved.end();
+  }
+  const_iterator begin() const
+  {
+    resolve();
+    return _resolved.begin();
+  }
+  const_iterator end() const
+  {
+    resolve();
+    return _resolved.end();
+  }
+
+  // first and last, as pos for insert, must come from begin() or end() of this list, which built the references.
+  iterator erase(const_iterator first, const_iterator last) { return _resolved.erase(first, last); }
+
+  template <typename InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last)
+  {
+    return _resolved.insert(pos, first, last);
+  }
+
+private:
+  void resolve() const
+  {
+    if (_lazy.empty()) { return; }
+    _resolved.reserve(_resolved.size() + _lazy.size());
+    for (const auto& strings : _lazy) { _resolved.push_back(strings.resolve(*_source)); }
+    _lazy.clear();
+  }
+
+  // Mutable since building the references does not change what the list holds.
+  mutable std::vector<audit_strings> _resolved;
+  mutable std::vector<lazy_audit_strings> _lazy;
+  std::shared_ptr<const std::string> _source;
+};
 }  // namespace VW
 
 using audit_strings VW_DEPRECATED("Moved into VW namespace") = VW::audit_strings;
@@ -418,9 +570,9 @@ struct features
   using const_extent_iterator =
       ns_extent_iterator<const features, const_audit_iterator, std::vector<VW::namespace_extent>::const_iterator>;
 
-  VW::v_array<feature_value> values;           // Always needed.
-  VW::v_array<feature_index> indices;          // Optional for sparse data.
-  std::vector<VW::audit_strings> space_names;  // Optional for audit mode.
+  VW::v_array<feature_value> values;  // Always needed.
+  VW::v_array<feature_index> indices;  // Optional for sparse data.
+  VW::audit_strings_list space_names;  // Optional for audit mode.
 
   // Each extent represents a range [begin, end) of values which exist in a
   // given namespace. These extents must not overlap and the indices must not go
@@ -193,4 +193,24 @@ void cs_prep_labels(VW::multi_ex& examples, std::vector<CB::label>& cb_labels, C
   }
 }
 
+void cs_ldf_multipredict(VW::LEARNER::multi_learner& base, VW::multi_ex& examples, std::vector<CB::label>& cb_labels,
+    COST_SENSITIVE::label& cs_labels, std::vector<COST_SENSITIVE::label>& prepped_cs_labels, uint64_t offset,
+    size_t id, size_t count, VW::polyprediction* pred)
+{
+  cs_prep_labels(examples, cb_labels, cs_labels, prepped_cs_labels, offset);
+
+  uint64_t saved_offset = examples[0]->ft_offset;
+  auto restore_guard = VW::scope_exit([&cb_labels, &prepped_cs_labels, saved_offset, &examples] {
+    for (size_t i = 0; i < examples.size(); ++i)
+    {
+      prepped_cs_labels[i] = std::move(examples[i]->l.cs);
+      examples[i]->l.cs.costs.clear();
+      examples[i]->l.cb = std::move(cb_labels[i]);
+      examples[i]->ft_offset = saved_offset;
+    }
+  });
+
+  base.multipredict(examples, id, count, pred, false);
+}
+
 }  // namespace GEN_CS
@@ -289,4 +289,10 @@ void cs_ldf_learn_or_predict(VW::LEARNER::multi_learner& base, VW::multi_ex& exa
     base.predict(examples, static_cast<int32_t>(id));
 }
 
+// Predicts with the `count` policies of the cost sensitive learner starting at `id` in one call, see
+// learner::multipredict. The prediction of policy `id + c` is written to pred[c].
+void cs_ldf_multipredict(VW::LEARNER::multi_learner& base, VW::multi_ex& examples, std::vector<CB::label>& cb_labels,
+    COST_SENSITIVE::label& cs_labels, std::vector<COST_SENSITIVE::label>& prepped_cs_labels, uint64_t offset,
+    size_t id, size_t count, VW::polyprediction* pred);
+
 }  // namespace GEN_CS
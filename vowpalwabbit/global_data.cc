@@ -395,6 +395,7 @@ workspace::workspace(VW::io::logger logger) : options(nullptr, nullptr), logger(
   daemon = false;
   num_children = 10;
   save_resume = true;
+  dense_model_weights = false;
   preserve_performance_counters = false;
 
   random_positive_weights = false;
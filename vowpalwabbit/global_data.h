@@ -17,6 +17,7 @@
 #include <cfloat>
 #include <cinttypes>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -128,6 +129,10 @@ public:
   VW::LEARNER::base_learner*
       cost_sensitive;  // a cost sensitive learning algorithm.  can be single or multi line learner
 
+  // Optional candidate pruning for large action sets. When set, csoaa_ldf in rank mode only scores the actions of a
+  // multi_ex for which it returns true, the others are ranked last without being scored.
+  std::function<bool(const multi_ex& actions, size_t index)> action_candidate_filter;
+
   void learn(example&);
   void learn(multi_ex&);
   void predict(example&);
@@ -179,6 +184,7 @@ public:
   bool bfgs;
 
   bool save_resume;
+  bool dense_model_weights;  // store the weight table as one page aligned section, see GD::save_load_dense_weights
   bool preserve_performance_counters;
   std::string id;
 
@@ -199,6 +205,8 @@ public:
   std::unique_ptr<VW::io::writer> stdout_adapter;
 
   std::vector<std::string> initial_regressors;
+  std::string shared_weights_input;   // --shared_weights
+  std::string shared_weights_output;  // --save_shared_weights
 
   std::string feature_mask;
 
@@ -316,6 +324,9 @@ public:
   // hack to support cb model loading into ccb reduction
   bool is_ccb_input_model = false;
 
+  // Names of the setup functions that added a learner to the stack, base first. See VW::resolve_setup.
+  std::vector<std::string> enabled_setup_functions;
+
   explicit workspace(VW::io::logger logger);
   ~workspace();
   std::shared_ptr<VW::rand_state> get_random_state() { return _random_state_sp; }
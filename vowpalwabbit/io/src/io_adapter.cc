@@ -87,6 +87,7 @@ struct file_adapter : public writer, public reader
   ssize_t read(char* buffer, size_t num_bytes) override;
   ssize_t write(const char* buffer, size_t num_bytes) override;
   void reset() override;
+  int file_descriptor() const override { return _mode == file_mode::read ? _file_descriptor : -1; }
 
 private:
   int _file_descriptor;
@@ -126,6 +126,7 @@ void io_buf::replace_buffer(char* buff, size_t capacity)
   _buffer._end = buff + capacity;
   _buffer._end_array = buff + capacity;
   head = buff;
+  _stream_offset = capacity;
 }
 
 void io_buf::flush()
@@ -137,6 +138,7 @@ void io_buf::flush()
   {
     auto bytes_written = output_files[0]->write(_buffer._begin, unflushed_bytes_count());
     if (bytes_written != static_cast<ssize_t>(unflushed_bytes_count())) { THROW("Failed to write example"); }
+    _stream_offset += static_cast<uint64_t>(bytes_written);
     head = _buffer._begin;
     output_files[0]->flush();
   }
@@ -151,6 +153,7 @@ void io_buf::reset()
   _buffer._end = _buffer._begin;
   head = _buffer._begin;
   _current = 0;
+  _stream_offset = 0;
 }
 
 bool io_buf::is_resettable() const
@@ -98,6 +98,9 @@ class io_buf
   // file descriptor currently being used.
   size_t _current = 0;
 
+  // Bytes read from the input files, or flushed to the output file, so far.
+  uint64_t _stream_offset = 0;
+
   std::vector<std::unique_ptr<VW::io::reader>> input_files;
   std::vector<std::unique_ptr<VW::io::writer>> output_files;
 
@@ -188,6 +191,7 @@ public:
     {
       // if some bytes were actually loaded, update the end of loaded values
       _buffer._end += num_read;
+      _stream_offset += num_read;
       return num_read;
     }
 
@@ -199,6 +203,14 @@ public:
   //   - Read mode: The offset of the position that has been read up to so far.
   size_t unflushed_bytes_count() { return head - _buffer._begin; }
 
+  // Position of head in the stream: bytes consumed so far in read mode, bytes produced so far in write mode. Across
+  // several input files this is the position in their concatenation.
+  uint64_t stream_offset() const
+  {
+    if (!input_files.empty()) { return _stream_offset - static_cast<uint64_t>(_buffer._end - head); }
+    return _stream_offset + static_cast<uint64_t>(head - _buffer._begin);
+  }
+
   void flush();
 
   bool close_file()
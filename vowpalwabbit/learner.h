@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <memory>
+#include <utility>
 
 #ifdef _WIN32
 #  pragma warning(push)
@@ -35,6 +36,12 @@
 
 namespace VW
 {
+class reduction_profiler;
+namespace reductions
+{
+struct stack_fuser;
+}
+
 /// \brief Contains the VW::LEARNER::learner object and utilities for
 /// interacting with it.
 namespace LEARNER
@@ -184,6 +191,28 @@ inline void decrement_offset(multi_ex& ec_seq, const size_t increment, const siz
   }
   debug_decrement_depth(ec_seq);
 }
+
+// Used by learner::multipredict for learners which do not implement it, one predict call per prediction.
+inline void predict_into(learn_data& fd, example& ec, polyprediction& pred, bool finalize_predictions)
+{
+  fd.predict_f(fd.data, *fd.base, &ec);
+  if (finalize_predictions)
+    pred = std::move(ec.pred);  // TODO: this breaks for complex labels because = doesn't do deep copy! (XXX we
+                                // "fix" this by moving)
+  else
+    pred.scalar = ec.partial_prediction;
+  // pred.scalar = finalize_prediction ec.partial_prediction; // TODO: this breaks for complex labels because =
+  // doesn't do deep copy! // note works if ec.partial_prediction, but only if finalize_prediction is run????
+}
+
+// Multiline learners leave their prediction on the first example. The caller's prediction is swapped in for the
+// duration of the call, so its buffers are reused and the first example's own prediction is left as it was.
+inline void predict_into(learn_data& fd, multi_ex& ec_seq, polyprediction& pred, bool /*finalize_predictions*/)
+{
+  std::swap(ec_seq[0]->pred, pred);
+  auto restore_guard = VW::scope_exit([&ec_seq, &pred] { std::swap(ec_seq[0]->pred, pred); });
+  fd.predict_f(fd.data, *fd.base, &ec_seq);
+}
 }  // namespace details
 
 bool ec_is_example_header(example const& ec, label_type_t label_type);
@@ -222,6 +251,8 @@ private:
   friend struct reduction_learner_builder;
   template <class ExampleT, class BaseLearnerT>
   friend struct reduction_no_data_learner_builder;
+  friend class VW::reduction_profiler;
+  friend struct VW::reductions::stack_fuser;
 
   details::func_data init_fd;
   details::learn_data learn_fd;
@@ -315,14 +346,7 @@ public:
       debug_log_message(ec, "multipredict");
       for (size_t c = 0; c < count; c++)
       {
-        learn_fd.predict_f(learn_fd.data, *learn_fd.base, (void*)&ec);
-        if (finalize_predictions)
-          pred[c] = std::move(ec.pred);  // TODO: this breaks for complex labels because = doesn't do deep copy! (XXX we
-                                         // "fix" this by moving)
-        else
-          pred[c].scalar = ec.partial_prediction;
-        // pred[c].scalar = finalize_prediction ec.partial_prediction; // TODO: this breaks for complex labels because =
-        // doesn't do deep copy! // note works if ec.partial_prediction, but only if finalize_prediction is run????
+        details::predict_into(learn_fd, ec, pred[c], finalize_predictions);
         details::increment_offset(ec, increment, 1);
       }
       details::decrement_offset(ec, increment, lo + count);
@@ -0,0 +1,33 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "object_pool.h"
+
+#include <functional>
+#include <thread>
+
+namespace VW
+{
+namespace details
+{
+size_t this_thread_pool_slot()
+{
+  // Consecutive thread ids often differ only in their high bits, so the hash is mixed before being reduced.
+  static thread_local const size_t slot = []() {
+    uint64_t h = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }();
+  return slot;
+}
+
+size_t default_pool_shards()
+{
+  const size_t hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads > 0 ? hardware_threads : 1;
+}
+}  // namespace details
+}  // namespace VW
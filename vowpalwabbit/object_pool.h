@@ -4,9 +4,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <queue>
 #include <set>
 #include <stack>
+#include <unordered_set>
+#include <vector>
 
 // Mutex and CV cannot be used in managed C++, tell the compiler that this is unmanaged even if included in a managed
 // project.
@@ -191,4 +199,246 @@ private:
   mutable std::mutex m_lock;
   no_lock_object_pool<T, TInitializer, TCleanup> inner_pool;
 };
+
+namespace details
+{
+// Stable per thread, spreads the threads over the shards of a sharded_object_pool. Defined out of line, like
+// default_pool_shards, since threads cannot be used in managed C++.
+size_t this_thread_pool_slot();
+// The number of hardware threads.
+size_t default_pool_shards();
+}  // namespace details
+
+struct object_pool_stats
+{
+  uint64_t allocated = 0;  // objects created, initially or because the pool had no free object
+  uint64_t trimmed = 0;    // objects destroyed when returned above the high-water mark
+  uint64_t acquired = 0;
+  uint64_t returned = 0;
+  uint64_t stolen = 0;  // objects moved from the shard of another thread, in batches
+};
+
+// A thread-safe pool for objects produced and freed from several threads.
+//
+// Free objects are spread over shards, each with its own lock, and a thread goes to the shard its slot maps to. When
+// that shard is empty it takes a batch of objects from the first other shard which is not busy, and only allocates a
+// new one when there is none. Objects can
+// be acquired and returned in batches, which costs one lock for the whole batch. If a high-water mark is set, objects
+// returned while that many are free already are destroyed rather than kept.
+template <typename T, typename TInitializer = default_initializer<T>, typename TCleanup = default_cleanup<T>>
+class sharded_object_pool
+{
+public:
+  // num_shards defaults to the number of hardware threads. high_water 0 keeps every returned object.
+  explicit sharded_object_pool(size_t initial_size = 0, size_t num_shards = 0, size_t high_water = 0,
+      TInitializer initializer = {})
+      : m_initializer(initializer)
+      , m_shards(num_shards > 0 ? num_shards : details::default_pool_shards())
+      , m_registry(m_shards.size())
+      , m_high_water(high_water)
+  {
+    for (size_t i = 0; i < initial_size; i++)
+    {
+      auto& s = m_shards[i % m_shards.size()];
+      s.free.push_back(create());
+    }
+    m_free_count = initial_size;
+  }
+
+  ~sharded_object_pool()
+  {
+    assert(m_free_count.load() == size());
+    for (auto& s : m_shards)
+    {
+      for (T* obj : s.free) { destroy(obj); }
+    }
+  }
+
+  sharded_object_pool(const sharded_object_pool&) = delete;
+  sharded_object_pool& operator=(const sharded_object_pool&) = delete;
+
+  T* get_object()
+  {
+    m_acquired.fetch_add(1, std::memory_order_relaxed);
+    const size_t home = home_shard();
+    {
+      std::unique_lock<std::mutex> lock(m_shards[home].lock);
+      if (!m_shards[home].free.empty()) { return pop_free(m_shards[home]); }
+    }
+    return steal_or_create(home);
+  }
+
+  // Appends count objects to objects.
+  void get_objects(size_t count, std::vector<T*>& objects)
+  {
+    m_acquired.fetch_add(count, std::memory_order_relaxed);
+    const size_t home = home_shard();
+    {
+      std::unique_lock<std::mutex> lock(m_shards[home].lock);
+      while (count > 0 && !m_shards[home].free.empty())
+      {
+        objects.push_back(pop_free(m_shards[home]));
+        count--;
+      }
+    }
+    for (; count > 0; count--) { objects.push_back(steal_or_create(home)); }
+  }
+
+  void return_object(T* obj) { return_objects(&obj, 1); }
+
+  void return_objects(T* const* objects, size_t count)
+  {
+    assert(std::all_of(objects, objects + count, [this](const T* obj) { return is_from_pool(obj); }));
+    m_returned.fetch_add(count, std::memory_order_relaxed);
+    size_t kept = count;
+    const size_t max_free = high_water();
+    if (max_free > 0)
+    {
+      const size_t free_count = m_free_count.load(std::memory_order_relaxed);
+      kept = free_count >= max_free ? 0 : std::min(count, max_free - free_count);
+      for (size_t i = kept; i < count; i++) { trim(objects[i]); }
+    }
+    if (kept == 0) { return; }
+
+    auto& s = m_shards[home_shard()];
+    std::unique_lock<std::mutex> lock(s.lock);
+    s.free.insert(s.free.end(), objects, objects + kept);
+    m_free_count.fetch_add(kept, std::memory_order_relaxed);
+  }
+
+  void return_objects(const std::vector<T*>& objects) { return_objects(objects.data(), objects.size()); }
+
+  // Whether no object is free, in which case the next one acquired is stolen or allocated.
+  bool empty() const { return m_free_count.load(std::memory_order_relaxed) == 0; }
+
+  // Objects owned by the pool, free or acquired.
+  size_t size() const
+  {
+    return static_cast<size_t>(m_allocated.load(std::memory_order_relaxed) - m_trimmed.load(std::memory_order_relaxed));
+  }
+
+  bool is_from_pool(const T* obj) const
+  {
+    const auto& r = m_registry[registry_index(obj)];
+    std::unique_lock<std::mutex> lock(r.lock);
+    return r.objects.count(obj) > 0;
+  }
+
+  size_t num_shards() const { return m_shards.size(); }
+  size_t high_water() const { return m_high_water.load(std::memory_order_relaxed); }
+  void set_high_water(size_t high_water) { m_high_water.store(high_water, std::memory_order_relaxed); }
+
+  object_pool_stats stats() const
+  {
+    object_pool_stats result;
+    result.allocated = m_allocated.load(std::memory_order_relaxed);
+    result.trimmed = m_trimmed.load(std::memory_order_relaxed);
+    result.acquired = m_acquired.load(std::memory_order_relaxed);
+    result.returned = m_returned.load(std::memory_order_relaxed);
+    result.stolen = m_stolen.load(std::memory_order_relaxed);
+    return result;
+  }
+
+private:
+  // Padded so that the locks of two shards do not share a cache line.
+  struct shard
+  {
+    std::mutex lock;
+    std::vector<T*> free;
+    char padding[64];
+  };
+
+  static constexpr size_t STEAL_BATCH = 16;
+
+  struct registry_shard
+  {
+    mutable std::mutex lock;
+    std::unordered_set<const T*> objects;
+  };
+
+  size_t home_shard() const { return details::this_thread_pool_slot() % m_shards.size(); }
+
+  size_t registry_index(const T* obj) const
+  {
+    return static_cast<size_t>(reinterpret_cast<uintptr_t>(obj) / sizeof(T)) % m_registry.size();
+  }
+
+  T* pop_free(shard& s)
+  {
+    T* obj = s.free.back();
+    s.free.pop_back();
+    m_free_count.fetch_sub(1, std::memory_order_relaxed);
+    return obj;
+  }
+
+  // When objects are acquired by one thread and returned by another, as between the parser and the learner, the
+  // shard of the first one keeps running empty. Stealing a batch makes that happen once every STEAL_BATCH objects.
+  T* steal_or_create(size_t home)
+  {
+    std::array<T*, STEAL_BATCH> stolen;
+    size_t num_stolen = 0;
+    for (size_t i = 1; i < m_shards.size() && num_stolen == 0 && !empty(); i++)
+    {
+      auto& s = m_shards[(home + i) % m_shards.size()];
+      std::unique_lock<std::mutex> lock(s.lock, std::try_to_lock);
+      if (!lock.owns_lock()) { continue; }
+      while (num_stolen < STEAL_BATCH && num_stolen < (s.free.size() + 1) / 2) { stolen[num_stolen++] = pop_free(s); }
+    }
+    if (num_stolen == 0) { return create(); }
+
+    m_stolen.fetch_add(num_stolen, std::memory_order_relaxed);
+    if (num_stolen > 1)
+    {
+      // Not done while holding the lock of the other shard, so that two threads stealing from each other cannot
+      // deadlock.
+      auto& s = m_shards[home];
+      std::unique_lock<std::mutex> lock(s.lock);
+      s.free.insert(s.free.end(), stolen.begin() + 1, stolen.begin() + num_stolen);
+      m_free_count.fetch_add(num_stolen - 1, std::memory_order_relaxed);
+    }
+    return stolen[0];
+  }
+
+  T* create()
+  {
+    T* obj = m_initializer(new T);
+    auto& r = m_registry[registry_index(obj)];
+    {
+      std::unique_lock<std::mutex> lock(r.lock);
+      r.objects.insert(obj);
+    }
+    m_allocated.fetch_add(1, std::memory_order_relaxed);
+    return obj;
+  }
+
+  void destroy(T* obj)
+  {
+    {
+      auto& r = m_registry[registry_index(obj)];
+      std::unique_lock<std::mutex> lock(r.lock);
+      r.objects.erase(obj);
+    }
+    m_cleanup(obj);
+    delete obj;
+  }
+
+  void trim(T* obj)
+  {
+    destroy(obj);
+    m_trimmed.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  TInitializer m_initializer;
+  TCleanup m_cleanup;
+  std::vector<shard> m_shards;
+  std::vector<registry_shard> m_registry;
+  std::atomic<size_t> m_high_water;
+
+  std::atomic<size_t> m_free_count{0};
+  std::atomic<uint64_t> m_allocated{0};
+  std::atomic<uint64_t> m_trimmed{0};
+  std::atomic<uint64_t> m_acquired{0};
+  std::atomic<uint64_t> m_returned{0};
+  std::atomic<uint64_t> m_stolen{0};
+};
 }  // namespace VW
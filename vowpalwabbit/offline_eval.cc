@@ -0,0 +1,247 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "offline_eval.h"
+
+#include "cb.h"
+#include "example.h"
+#include "global_data.h"
+#include "learner.h"
+#include "memory.h"
+#include "parse_example_json.h"
+#include "vw.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/options.h"
+
+#include <algorithm>
+#include <exception>
+#include <istream>
+#include <thread>
+
+namespace
+{
+// Number of events parsed before the policies are evaluated on them.
+constexpr size_t BATCH_SIZE = 256;
+}  // namespace
+
+namespace VW
+{
+// A workspace with its own copy of the event it processes. The copy is made from the examples parsed by the reader
+// before they are set up, so that each workspace applies its own options (constant feature, ignored namespaces,
+// interactions, weights per problem) when setting it up.
+struct offline_evaluator::worker
+{
+  explicit worker(VW::workspace& all) : all(all) {}
+
+  VW::multi_ex& copy_event(const VW::multi_ex& event)
+  {
+    while (pool.size() < event.size()) { pool.push_back(VW::make_unique<VW::example>()); }
+
+    copy.clear();
+    for (size_t i = 0; i < event.size(); i++)
+    {
+      VW::example* ec = pool[i].get();
+      VW::empty_example(all, *ec);
+      VW::copy_example_data_with_label(ec, event[i]);
+      VW::setup_example(all, ec);
+      copy.push_back(ec);
+    }
+    return copy;
+  }
+
+  VW::workspace& all;
+  std::vector<std::unique_ptr<VW::example>> pool;
+  VW::multi_ex copy;
+};
+
+struct offline_evaluator::policy
+{
+  policy(VW::workspace& all, double alpha) : ws(all), cost_bound(alpha, 1.), negated_cost_bound(alpha, 1.) {}
+
+  worker ws;
+  size_t events = 0;
+  double sum_ips = 0.;
+  double sum_weights = 0.;
+  double sum_dr = 0.;
+  // Lower bounds of the expected cost and of the expected negated cost.
+  VW::distributionally_robust::ChiSquared cost_bound;
+  VW::distributionally_robust::ChiSquared negated_cost_bound;
+};
+
+offline_evaluator::offline_evaluator(
+    VW::workspace& reader, std::vector<VW::workspace*> policies, size_t num_threads, double alpha)
+    : _num_threads(std::max<size_t>(1, std::min(num_threads, policies.size())))
+{
+  if (!reader.options->was_supplied("dsjson") && !reader.options->was_supplied("json"))
+  { THROW("offline_evaluator requires a reader initialized with --dsjson or --json"); }
+  if (!reader.l->is_multiline() || reader.l->get_output_prediction_type() != VW::prediction_type_t::action_scores)
+  { THROW("offline_evaluator requires a reader predicting action scores, such as --cb_adf"); }
+  if (policies.empty()) { THROW("offline_evaluator requires at least one policy"); }
+
+  _reader = VW::make_unique<worker>(reader);
+  for (auto* all : policies)
+  {
+    if (all == nullptr) { THROW("offline_evaluator was given a null policy"); }
+    if (!all->l->is_multiline() || all->l->get_output_prediction_type() != VW::prediction_type_t::action_probs)
+    { THROW("offline_evaluator requires policies predicting a pmf, such as --cb_explore_adf"); }
+    _policies.push_back(VW::make_unique<policy>(*all, alpha));
+    if (!_policies.back()->cost_bound.isValid()) { THROW("offline_evaluator alpha must be in (0, 1]"); }
+  }
+}
+
+offline_evaluator::~offline_evaluator()
+{
+  for (const auto& event : _events) { _parsed.insert(_parsed.end(), event.begin(), event.end()); }
+  VW::return_multiple_example(_reader->all, _parsed);
+}
+
+void offline_evaluator::evaluate(std::istream& log)
+{
+  std::string line;
+  while (std::getline(log, line))
+  {
+    if (line.empty() || !parse(line)) { continue; }
+    if (_events.size() == BATCH_SIZE) { evaluate_batch(); }
+  }
+  evaluate_batch();
+}
+
+bool offline_evaluator::parse(std::string& line)
+{
+  VW::workspace& reader = _reader->all;
+  _parsed.push_back(VW::new_unused_example(reader));
+  // The line is parsed in place.
+  const bool parsed = parse_line_json<false>(&reader, &line[0], line.size(), _parsed);
+
+  logged_event logged;
+  logged.first_action = 0;
+  bool labeled = false;
+  if (parsed)
+  {
+    const auto label_type = reader.example_parser->lbl_parser.label_type;
+    logged.first_action = !_parsed.empty() && VW::LEARNER::ec_is_example_header(*_parsed[0], label_type) ? 1 : 0;
+    for (size_t i = logged.first_action; i < _parsed.size(); i++)
+    {
+      const auto observed = CB::get_observed_cost_cb(_parsed[i]->l.cb);
+      if (observed.first && observed.second.probability > 0.f)
+      {
+        logged.action = static_cast<uint32_t>(i - logged.first_action);
+        logged.cost = observed.second.cost;
+        logged.probability = observed.second.probability;
+        labeled = true;
+        break;
+      }
+    }
+  }
+
+  if (!labeled)
+  {
+    VW::return_multiple_example(reader, _parsed);
+    return false;
+  }
+
+  _events.emplace_back(_parsed.begin(), _parsed.end());
+  _logged.push_back(std::move(logged));
+  _parsed.clear();
+  return true;
+}
+
+void offline_evaluator::evaluate_batch()
+{
+  if (_events.empty()) { return; }
+
+  // The reward model predicts every event before learning from it, so its estimates are out of sample too.
+  VW::workspace& reader = _reader->all;
+  for (size_t e = 0; e < _events.size(); e++)
+  {
+    auto& event = _reader->copy_event(_events[e]);
+    reader.predict(event);
+    auto& estimated_costs = _logged[e].estimated_costs;
+    estimated_costs.assign(event.size() - _logged[e].first_action, 0.f);
+    for (const auto& as : event[0]->pred.a_s)
+    {
+      if (as.action < estimated_costs.size()) { estimated_costs[as.action] = as.score; }
+    }
+    reader.learn(event);
+  }
+
+  std::vector<std::exception_ptr> errors(_num_threads);
+  auto evaluate_share = [this, &errors](size_t t) {
+    try
+    {
+      for (size_t i = t; i < _policies.size(); i += _num_threads) { evaluate_policy(*_policies[i]); }
+    }
+    catch (...)
+    {
+      errors[t] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(_num_threads - 1);
+  for (size_t t = 1; t < _num_threads; t++) { threads.emplace_back(evaluate_share, t); }
+  evaluate_share(0);
+  for (auto& thread : threads) { thread.join(); }
+
+  for (auto& event : _events) { _parsed.insert(_parsed.end(), event.begin(), event.end()); }
+  VW::return_multiple_example(reader, _parsed);
+  _events.clear();
+  _logged.clear();
+
+  for (const auto& error : errors)
+  {
+    if (error) { std::rethrow_exception(error); }
+  }
+}
+
+void offline_evaluator::evaluate_policy(policy& p)
+{
+  VW::workspace& all = p.ws.all;
+  for (size_t e = 0; e < _events.size(); e++)
+  {
+    const auto& logged = _logged[e];
+    auto& event = p.ws.copy_event(_events[e]);
+    if (!all.l->learn_returns_prediction) { all.predict(event); }
+    all.learn(event);
+
+    double direct = 0.;
+    float logged_pmf = 0.f;
+    for (const auto& as : event[0]->pred.a_s)
+    {
+      if (as.action >= logged.estimated_costs.size()) { continue; }
+      direct += as.score * logged.estimated_costs[as.action];
+      if (as.action == logged.action) { logged_pmf = as.score; }
+    }
+
+    const double w = logged_pmf / logged.probability;
+    p.events++;
+    p.sum_ips += w * logged.cost;
+    p.sum_weights += w;
+    p.sum_dr += direct + w * (logged.cost - logged.estimated_costs[logged.action]);
+    p.cost_bound.update(w, logged.cost);
+    p.negated_cost_bound.update(w, -logged.cost);
+  }
+}
+
+std::vector<policy_estimates> offline_evaluator::estimates() const
+{
+  std::vector<policy_estimates> result;
+  result.reserve(_policies.size());
+  for (const auto& p : _policies)
+  {
+    policy_estimates estimates;
+    estimates.events = p->events;
+    if (p->events > 0)
+    {
+      estimates.ips = p->sum_ips / p->events;
+      estimates.snips = p->sum_weights > 0. ? p->sum_ips / p->sum_weights : 0.;
+      estimates.dr = p->sum_dr / p->events;
+      estimates.lower_bound = p->cost_bound.lower_bound();
+      estimates.upper_bound = -p->negated_cost_bound.lower_bound();
+    }
+    result.push_back(estimates);
+  }
+  return result;
+}
+}  // namespace VW
@@ -0,0 +1,84 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "distributionally_robust.h"
+#include "v_array.h"
+#include "vw_fwd.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VW
+{
+// Off-policy estimates of the expected cost of a policy over a contextual bandit log.
+struct policy_estimates
+{
+  size_t events = 0;  // number of labeled events evaluated
+  double ips = 0.;    // inverse propensity score
+  double snips = 0.;  // self normalized inverse propensity score
+  double dr = 0.;     // doubly robust, with the reward model learned by the reader of the log
+  // Distributionally robust confidence interval of the expected cost, at level 1 - alpha.
+  double lower_bound = 0.;
+  double upper_bound = 0.;
+};
+
+// Evaluates many contextual bandit policies in one pass over a log, such as a grid of --cb_explore_adf configurations
+// which would otherwise take a --explore_eval run each.
+//
+// The log is parsed once, by the reader workspace, which must be initialized with --dsjson (or --json) and a reduction
+// stack predicting action scores, such as --cb_adf. The reader also learns the reward model of the doubly robust
+// estimate. Each policy is a workspace with a multiline contextual bandit reduction stack predicting a pmf, such as
+// --cb_explore_adf, which must hash features like the reader does (same --hash, --hash_seed and namespace options).
+//
+// Policies are evaluated progressively, like --explore_eval: each logged event is predicted on before the policy
+// learns from it. They are split over num_threads threads, the first of which is the calling thread. A workspace must
+// not be used elsewhere during an evaluation.
+class offline_evaluator
+{
+public:
+  offline_evaluator(VW::workspace& reader, std::vector<VW::workspace*> policies, size_t num_threads = 1,
+      double alpha = DEFAULT_ALPHA);
+  ~offline_evaluator();
+
+  offline_evaluator(const offline_evaluator&) = delete;
+  offline_evaluator& operator=(const offline_evaluator&) = delete;
+
+  // Evaluates the events of a log, one per line. Events without a logged action and cost are skipped.
+  void evaluate(std::istream& log);
+
+  // Estimates of every policy, in the order they were given, over all the events evaluated so far.
+  std::vector<policy_estimates> estimates() const;
+
+private:
+  struct worker;
+  struct policy;
+
+  struct logged_event
+  {
+    size_t first_action = 0;  // 1 after a shared example, 0 otherwise
+    uint32_t action = 0;      // logged action, counted from the first action
+    float cost = 0.f;
+    float probability = 0.f;
+    std::vector<float> estimated_costs;  // reward model prediction for each action
+  };
+
+  bool parse(std::string& line);
+  void evaluate_batch();
+  void evaluate_policy(policy& p);
+
+  std::unique_ptr<worker> _reader;
+  std::vector<std::unique_ptr<policy>> _policies;
+  size_t _num_threads;
+
+  // The current batch of events, parsed by the reader and copied by each policy.
+  std::vector<VW::multi_ex> _events;
+  std::vector<logged_event> _logged;
+  VW::v_array<VW::example*> _parsed;
+};
+}  // namespace VW
@@ -0,0 +1,121 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+// Asynchronous parameter server. Workers pull shards of the weight table and push sparse deltas at their own pace,
+// so unlike the spanning tree allreduce a slow node never stalls the others.
+#pragma once
+
+#include "vw/spanning_tree/socket_utils.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VW
+{
+namespace parameter_server_protocol
+{
+// The wire protocol. All integers are sent in host byte order, as is done by the spanning tree and allreduce.
+//
+// On connect the client sends a single '\0' byte (see open_socket() in network.cc), then a hello consisting of the
+// uint64_t number of weights in the shard it wants to talk to. The server answers with an int32_t shard_reply. After
+// that the client sends any number of requests, each starting with a one byte opcode:
+//
+//   pull:         uint64_t begin, uint64_t count -> server replies with count floats
+//   push:         uint64_t count, followed by count (uint64_t index, float delta) records. There is no reply.
+//   close:        no payload, the server closes the connection.
+//   pull_indices: uint64_t count, followed by count uint64_t indices -> server replies with count floats
+enum class opcode : uint8_t
+{
+  close = 0,
+  pull = 1,
+  push = 2,
+  pull_indices = 3
+};
+
+// Answer to the hello. The first worker of a shard is told that it is empty, so that it can seed it with its model.
+enum class shard_reply : int32_t
+{
+  rejected = 0,
+  accepted = 1,
+  accepted_empty = 2
+};
+
+constexpr uint16_t DEFAULT_PORT = 26544;
+
+// Number of (index, delta) records, or of indices to pull, sent or received in a single batch.
+constexpr size_t PUSH_BATCH_SIZE = 4096;
+
+#pragma pack(push, 1)
+struct push_record
+{
+  uint64_t index;
+  float delta;
+};
+#pragma pack(pop)
+
+// Blocking helpers which loop until the full buffer is transferred. Return false if the peer went away.
+bool send_all(socket_t sock, const void* buffer, size_t length);
+bool recv_all(socket_t sock, void* buffer, size_t length);
+}  // namespace parameter_server_protocol
+
+class parameter_server
+{
+public:
+  parameter_server(uint16_t port = parameter_server_protocol::DEFAULT_PORT, bool quiet = false);
+  ~parameter_server();
+
+  parameter_server(const parameter_server&) = delete;
+  parameter_server& operator=(const parameter_server&) = delete;
+
+  uint16_t bound_port() const { return _port; }
+
+  // Runs the accept loop on a background thread.
+  void start();
+  // Runs the accept loop on the calling thread until stop() is called. Throws if connections can no longer be
+  // accepted.
+  void run();
+  // Stops accepting connections and closes the ones of the workers. Rethrows the error which ended the loop started
+  // by start(), if any.
+  void stop();
+
+  // Copy of the current weight table, mostly useful for testing.
+  std::vector<float> weights() const;
+  uint64_t pushes_applied() const { return _pushes_applied.load(); }
+  uint64_t pulls_served() const { return _pulls_served.load(); }
+
+private:
+  struct client_connection
+  {
+    socket_t sock;
+    bool finished = false;  // set by its thread once the socket is closed, which can then be joined
+    std::thread thread;
+  };
+
+  void serve_client(client_connection* connection);
+  parameter_server_protocol::shard_reply accept_shard(uint64_t length);
+  void join_finished_clients();
+  void close_clients();
+
+  std::atomic<bool> _stop;
+  socket_t _sock;
+  uint16_t _port;
+  bool _quiet;
+  std::future<void> _future;
+
+  mutable std::mutex _weights_mutex;
+  std::vector<float> _weights;
+
+  std::mutex _clients_mutex;
+  std::list<client_connection> _clients;
+
+  std::atomic<uint64_t> _pushes_applied;
+  std::atomic<uint64_t> _pulls_served;
+};
+}  // namespace VW
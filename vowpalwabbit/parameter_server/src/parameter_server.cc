@@ -0,0 +1,302 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/parameter_server/parameter_server.h"
+
+#include "vw/common/vw_exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+namespace VW
+{
+namespace parameter_server_protocol
+{
+bool send_all(socket_t sock, const void* buffer, size_t length)
+{
+  const char* current = static_cast<const char*>(buffer);
+  while (length > 0)
+  {
+    auto sent = send(sock, current, static_cast<int>(length), details::SEND_FLAGS);
+    if (sent <= 0) { return false; }
+    current += sent;
+    length -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+bool recv_all(socket_t sock, void* buffer, size_t length)
+{
+  char* current = static_cast<char*>(buffer);
+  while (length > 0)
+  {
+    auto received = recv(sock, current, static_cast<int>(length), 0);
+    if (received <= 0) { return false; }
+    current += received;
+    length -= static_cast<size_t>(received);
+  }
+  return true;
+}
+}  // namespace parameter_server_protocol
+
+namespace ps = parameter_server_protocol;
+
+namespace
+{
+// How long to wait before accepting again when out of file descriptors or buffers.
+constexpr int ACCEPT_RETRY_MS = 100;
+
+// Errors of accept() which only concern the connection being accepted, or resources which may free up again.
+bool is_transient_accept_error()
+{
+#ifdef _WIN32
+  const int error = WSAGetLastError();
+  return error == WSAECONNRESET || error == WSAEINTR || error == WSAEWOULDBLOCK || error == WSAEMFILE ||
+      error == WSAENOBUFS;
+#else
+  return errno == EINTR || errno == ECONNABORTED || errno == EPROTO || errno == EAGAIN || errno == EWOULDBLOCK ||
+      errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM;
+#endif
+}
+}  // namespace
+
+parameter_server::parameter_server(uint16_t port, bool quiet)
+    : _stop(false), _port(port), _quiet(quiet), _pushes_applied(0), _pulls_served(0)
+{
+  details::socket_library_startup();
+  _sock = details::open_listening_socket(port, _port);
+}
+
+parameter_server::~parameter_server()
+{
+  try
+  {
+    stop();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "parameter server: " << e.what() << std::endl;
+  }
+  details::socket_library_cleanup();
+}
+
+void parameter_server::start() { _future = std::async(std::launch::async, &parameter_server::run, this); }
+
+void parameter_server::stop()
+{
+  if (!_stop.exchange(true))
+  {
+#ifndef _WIN32
+    // just close won't unblock the accept
+    shutdown(_sock, SHUT_RD);
+#endif
+    CLOSESOCK(_sock);
+  }
+
+  std::exception_ptr error;
+  if (_future.valid())
+  {
+    try
+    {
+      _future.get();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+  }
+  close_clients();
+  if (error) { std::rethrow_exception(error); }
+}
+
+void parameter_server::join_finished_clients()
+{
+  std::list<client_connection> finished;
+  {
+    std::lock_guard<std::mutex> lock(_clients_mutex);
+    for (auto it = _clients.begin(); it != _clients.end();)
+    {
+      auto current = it++;
+      if (current->finished) { finished.splice(finished.end(), _clients, current); }
+    }
+  }
+  for (auto& client : finished) { client.thread.join(); }
+}
+
+void parameter_server::close_clients()
+{
+  std::list<client_connection> clients;
+  {
+    std::lock_guard<std::mutex> lock(_clients_mutex);
+#ifndef _WIN32
+    // unblock any client threads waiting in recv, the sockets of finished ones are closed already
+    for (auto& client : _clients)
+    {
+      if (!client.finished) { shutdown(client.sock, SHUT_RDWR); }
+    }
+#endif
+    clients.swap(_clients);
+  }
+  for (auto& client : clients) { client.thread.join(); }
+}
+
+std::vector<float> parameter_server::weights() const
+{
+  std::lock_guard<std::mutex> lock(_weights_mutex);
+  return _weights;
+}
+
+ps::shard_reply parameter_server::accept_shard(uint64_t length)
+{
+  if (length == 0) { return ps::shard_reply::rejected; }
+  std::lock_guard<std::mutex> lock(_weights_mutex);
+  // The first worker to connect decides the size of the shard, everyone after must agree.
+  if (_weights.empty())
+  {
+    _weights.resize(static_cast<size_t>(length), 0.f);
+    return ps::shard_reply::accepted_empty;
+  }
+  return _weights.size() == length ? ps::shard_reply::accepted : ps::shard_reply::rejected;
+}
+
+void parameter_server::run()
+{
+  while (!_stop)
+  {
+    // Threads of workers which went away are joined here, rather than when the server stops.
+    join_finished_clients();
+
+    sockaddr_in client_address;
+    socklen_t size = sizeof(client_address);
+    socket_t f = accept(_sock, reinterpret_cast<sockaddr*>(&client_address), &size);
+    if (!details::is_valid_socket(f))
+    {
+      if (_stop) { break; }
+      if (is_transient_accept_error())
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ACCEPT_RETRY_MS));
+        continue;
+      }
+      THROWERRNO("parameter server: accept failed");
+    }
+
+    int on = 1;
+    setsockopt(f, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&on), sizeof(on));
+    details::disable_sigpipe(f);
+
+    if (!_quiet)
+    {
+      char dotted_quad[INET_ADDRSTRLEN];
+      if (inet_ntop(AF_INET, &(client_address.sin_addr), dotted_quad, INET_ADDRSTRLEN) != nullptr)
+      { std::cerr << "parameter server: inbound connection from " << dotted_quad << std::endl; }
+    }
+
+    std::lock_guard<std::mutex> lock(_clients_mutex);
+    _clients.emplace_back();
+    auto& connection = _clients.back();
+    connection.sock = f;
+    connection.thread = std::thread(&parameter_server::serve_client, this, &connection);
+  }
+}
+
+void parameter_server::serve_client(client_connection* connection)
+{
+  const socket_t client = connection->sock;
+  // open_socket() identifies itself with a single byte before anything else.
+  char id = 0;
+  uint64_t length = 0;
+  bool connected = ps::recv_all(client, &id, sizeof(id)) && ps::recv_all(client, &length, sizeof(length));
+  if (connected)
+  {
+    const auto reply = accept_shard(length);
+    if (reply == ps::shard_reply::rejected && !_quiet)
+    { std::cerr << "parameter server: rejecting worker with shard length " << length << std::endl; }
+    connected = ps::send_all(client, &reply, sizeof(reply)) && reply != ps::shard_reply::rejected;
+  }
+
+  std::vector<ps::push_record> records;
+  std::vector<uint64_t> indices;
+  std::vector<float> pulled;
+  while (connected && !_stop)
+  {
+    ps::opcode op;
+    if (!ps::recv_all(client, &op, sizeof(op))) { break; }
+
+    if (op == ps::opcode::pull)
+    {
+      uint64_t range[2];
+      if (!ps::recv_all(client, range, sizeof(range))) { break; }
+      {
+        std::lock_guard<std::mutex> lock(_weights_mutex);
+        if (range[0] > _weights.size() || range[1] > _weights.size() - range[0]) { break; }
+        pulled.assign(_weights.begin() + range[0], _weights.begin() + range[0] + range[1]);
+      }
+      if (!ps::send_all(client, pulled.data(), pulled.size() * sizeof(float))) { break; }
+      ++_pulls_served;
+    }
+    else if (op == ps::opcode::pull_indices)
+    {
+      uint64_t count = 0;
+      if (!ps::recv_all(client, &count, sizeof(count))) { break; }
+      while (count > 0)
+      {
+        size_t batch = static_cast<size_t>(std::min<uint64_t>(count, ps::PUSH_BATCH_SIZE));
+        indices.resize(batch);
+        pulled.resize(batch);
+        if (!ps::recv_all(client, indices.data(), batch * sizeof(uint64_t)))
+        {
+          connected = false;
+          break;
+        }
+        {
+          std::lock_guard<std::mutex> lock(_weights_mutex);
+          for (size_t i = 0; i < batch; i++)
+          { pulled[i] = indices[i] < _weights.size() ? _weights[static_cast<size_t>(indices[i])] : 0.f; }
+        }
+        if (!ps::send_all(client, pulled.data(), batch * sizeof(float)))
+        {
+          connected = false;
+          break;
+        }
+        count -= batch;
+      }
+      if (connected) { ++_pulls_served; }
+    }
+    else if (op == ps::opcode::push)
+    {
+      uint64_t count = 0;
+      if (!ps::recv_all(client, &count, sizeof(count))) { break; }
+      while (count > 0)
+      {
+        size_t batch = static_cast<size_t>(std::min<uint64_t>(count, ps::PUSH_BATCH_SIZE));
+        records.resize(batch);
+        if (!ps::recv_all(client, records.data(), batch * sizeof(ps::push_record)))
+        {
+          connected = false;
+          break;
+        }
+        std::lock_guard<std::mutex> lock(_weights_mutex);
+        for (const auto& record : records)
+        {
+          if (record.index < _weights.size()) { _weights[static_cast<size_t>(record.index)] += record.delta; }
+        }
+        count -= batch;
+      }
+      if (connected) { ++_pushes_applied; }
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(_clients_mutex);
+  CLOSESOCK(client);
+  connection->finished = true;
+}
+}  // namespace VW
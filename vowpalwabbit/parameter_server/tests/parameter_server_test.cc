@@ -0,0 +1,168 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/parameter_server/parameter_server.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace ps = VW::parameter_server_protocol;
+
+namespace
+{
+socket_t connect_worker(uint16_t port, uint64_t length, ps::shard_reply& reply)
+{
+  socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+  sockaddr_in far_end;
+  memset(&far_end, 0, sizeof(far_end));
+  far_end.sin_family = AF_INET;
+  far_end.sin_port = htons(port);
+  far_end.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&far_end), sizeof(far_end)), 0);
+
+  char id = '\0';
+  EXPECT_TRUE(ps::send_all(sock, &id, sizeof(id)));
+  EXPECT_TRUE(ps::send_all(sock, &length, sizeof(length)));
+  EXPECT_TRUE(ps::recv_all(sock, &reply, sizeof(reply)));
+  return sock;
+}
+
+void push(socket_t sock, const std::vector<ps::push_record>& records)
+{
+  auto op = ps::opcode::push;
+  uint64_t count = records.size();
+  EXPECT_TRUE(ps::send_all(sock, &op, sizeof(op)));
+  EXPECT_TRUE(ps::send_all(sock, &count, sizeof(count)));
+  EXPECT_TRUE(ps::send_all(sock, records.data(), records.size() * sizeof(ps::push_record)));
+}
+
+std::vector<float> pull(socket_t sock, uint64_t begin, uint64_t count)
+{
+  auto op = ps::opcode::pull;
+  uint64_t range[2] = {begin, count};
+  EXPECT_TRUE(ps::send_all(sock, &op, sizeof(op)));
+  EXPECT_TRUE(ps::send_all(sock, range, sizeof(range)));
+  std::vector<float> result(count);
+  EXPECT_TRUE(ps::recv_all(sock, result.data(), result.size() * sizeof(float)));
+  return result;
+}
+
+std::vector<float> pull_indices(socket_t sock, const std::vector<uint64_t>& indices)
+{
+  auto op = ps::opcode::pull_indices;
+  uint64_t count = indices.size();
+  EXPECT_TRUE(ps::send_all(sock, &op, sizeof(op)));
+  EXPECT_TRUE(ps::send_all(sock, &count, sizeof(count)));
+  EXPECT_TRUE(ps::send_all(sock, indices.data(), indices.size() * sizeof(uint64_t)));
+  std::vector<float> result(count);
+  EXPECT_TRUE(ps::recv_all(sock, result.data(), result.size() * sizeof(float)));
+  return result;
+}
+
+void disconnect(socket_t sock)
+{
+  auto op = ps::opcode::close;
+  ps::send_all(sock, &op, sizeof(op));
+  CLOSESOCK(sock);
+}
+}  // namespace
+
+TEST(parameter_server_tests, push_then_pull)
+{
+  VW::parameter_server server(0, true);
+  server.start();
+
+  auto reply = ps::shard_reply::rejected;
+  auto sock = connect_worker(server.bound_port(), 8, reply);
+  EXPECT_EQ(reply, ps::shard_reply::accepted_empty);
+
+  push(sock, {{1, 0.5f}, {3, -2.f}, {1, 0.25f}});
+  auto weights = pull(sock, 0, 8);
+  EXPECT_THAT(weights, testing::ElementsAre(0.f, 0.75f, 0.f, -2.f, 0.f, 0.f, 0.f, 0.f));
+
+  auto partial = pull(sock, 3, 2);
+  EXPECT_THAT(partial, testing::ElementsAre(-2.f, 0.f));
+
+  auto selected = pull_indices(sock, {3, 1, 3});
+  EXPECT_THAT(selected, testing::ElementsAre(-2.f, 0.75f, -2.f));
+
+  disconnect(sock);
+  server.stop();
+  EXPECT_EQ(server.pushes_applied(), 1);
+  EXPECT_EQ(server.pulls_served(), 3);
+}
+
+TEST(parameter_server_tests, mismatched_shard_is_rejected)
+{
+  VW::parameter_server server(0, true);
+  server.start();
+
+  auto reply = ps::shard_reply::rejected;
+  auto first = connect_worker(server.bound_port(), 16, reply);
+  EXPECT_EQ(reply, ps::shard_reply::accepted_empty);
+  auto second = connect_worker(server.bound_port(), 32, reply);
+  EXPECT_EQ(reply, ps::shard_reply::rejected);
+  auto third = connect_worker(server.bound_port(), 16, reply);
+  EXPECT_EQ(reply, ps::shard_reply::accepted);
+
+  CLOSESOCK(second);
+  disconnect(third);
+  disconnect(first);
+  server.stop();
+}
+
+TEST(parameter_server_tests, concurrent_workers_do_not_lose_updates)
+{
+  VW::parameter_server server(0, true);
+  server.start();
+
+  constexpr size_t num_workers = 4;
+  constexpr size_t num_pushes = 200;
+  std::vector<std::thread> workers;
+  for (size_t w = 0; w < num_workers; w++)
+  {
+    workers.emplace_back([&server]() {
+      auto reply = ps::shard_reply::rejected;
+      auto sock = connect_worker(server.bound_port(), 4, reply);
+      EXPECT_NE(reply, ps::shard_reply::rejected);
+      for (size_t i = 0; i < num_pushes; i++) { push(sock, {{0, 1.f}, {2, -1.f}}); }
+      // A pull on the same connection is only answered once all earlier pushes have been applied.
+      pull(sock, 0, 4);
+      disconnect(sock);
+    });
+  }
+  for (auto& worker : workers) { worker.join(); }
+
+  auto weights = server.weights();
+  EXPECT_FLOAT_EQ(weights[0], static_cast<float>(num_workers * num_pushes));
+  EXPECT_FLOAT_EQ(weights[2], -static_cast<float>(num_workers * num_pushes));
+  server.stop();
+}
+
+TEST(parameter_server_tests, worker_leaving_mid_reply_does_not_stop_server)
+{
+  VW::parameter_server server(0, true);
+  server.start();
+
+  // The reply is far larger than the socket buffers, so the server is still sending when the worker is gone.
+  constexpr uint64_t length = 1 << 22;
+  auto reply = ps::shard_reply::rejected;
+  auto leaving = connect_worker(server.bound_port(), length, reply);
+  auto op = ps::opcode::pull;
+  uint64_t range[2] = {0, length};
+  EXPECT_TRUE(ps::send_all(leaving, &op, sizeof(op)));
+  EXPECT_TRUE(ps::send_all(leaving, range, sizeof(range)));
+  CLOSESOCK(leaving);
+
+  auto staying = connect_worker(server.bound_port(), length, reply);
+  EXPECT_EQ(reply, ps::shard_reply::accepted);
+  push(staying, {{7, 1.5f}});
+  EXPECT_THAT(pull(staying, 6, 2), testing::ElementsAre(0.f, 1.5f));
+  disconnect(staying);
+  server.stop();
+}
@@ -0,0 +1,93 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+// Hosts one shard of the weight table for asynchronous parameter server training (vw --ps_servers).
+
+#include "vw/common/vw_exception.h"
+#include "vw/config/cli_help_formatter.h"
+#include "vw/config/option_builder.h"
+#include "vw/config/option_group_definition.h"
+#include "vw/config/options_cli.h"
+#include "vw/parameter_server/parameter_server.h"
+
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+int getpid() { return (int)::GetCurrentProcessId(); }
+#endif
+
+void usage(const VW::config::options_cli& desc)
+{
+  std::cout << "usage: parameter_server [--port,-p number] [--quiet] [--help,-h] [pid_file]" << std::endl;
+  VW::config::cli_help_formatter help_formatter;
+  std::cout << help_formatter.format_help(desc.get_all_option_group_definitions()) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  int port = VW::parameter_server_protocol::DEFAULT_PORT;
+  bool quiet = false;
+  bool help = false;
+
+  VW::config::options_cli opts(std::vector<std::string>(argv + 1, argv + argc));
+
+  VW::config::option_group_definition desc("Parameter Server");
+  desc.add(VW::config::make_option("quiet", quiet).help("Don't log inbound connections"))
+      .add(VW::config::make_option("help", help).short_name("h").help("Print help message"))
+      .add(VW::config::make_option("port", port)
+               .short_name("p")
+               .default_value(VW::parameter_server_protocol::DEFAULT_PORT)
+               .help("Port number for the parameter server to listen on"));
+
+  opts.add_and_parse(desc);
+  // Return value is ignored as option reachability is not relevant here.
+  auto warnings = opts.check_unregistered();
+  _UNUSED(warnings);
+  auto positional = opts.get_positional_tokens();
+  std::string pid_file_name;
+  if (!positional.empty())
+  {
+    pid_file_name = positional.front();
+    if (positional.size() > 1)
+    {
+      std::cerr << "Too many positional arguments" << std::endl;
+      usage(opts);
+      return 1;
+    }
+  }
+
+  if (help)
+  {
+    usage(opts);
+    return 0;
+  }
+
+  try
+  {
+    VW::parameter_server server(static_cast<uint16_t>(port), quiet);
+
+    if (!pid_file_name.empty())
+    {
+      std::ofstream pid_file;
+      pid_file.open(pid_file_name);
+      if (!pid_file.is_open())
+      {
+        std::cerr << "error writing pid file" << std::endl;
+        return 1;
+      }
+      pid_file << getpid() << std::endl;
+      pid_file.close();
+    }
+
+    if (!quiet) { std::cerr << "parameter server listening on port " << server.bound_port() << std::endl; }
+    server.run();
+  }
+  catch (VW::vw_exception& e)
+  {
+    std::cerr << "parameter server (" << e.Filename() << ":" << e.LineNumber() << "): " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
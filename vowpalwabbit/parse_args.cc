@@ -1242,7 +1242,13 @@ void parse_output_model(options_i& options, VW::workspace& all)
                .help("Per feature regularization output file"))
       .add(make_option("output_feature_regularizer_text", all.per_feature_regularizer_text)
                .help("Per feature regularization output file, in text"))
-      .add(make_option("id", all.id).help("User supplied ID embedded into the final regressor"));
+      .add(make_option("id", all.id).help("User supplied ID embedded into the final regressor"))
+      .add(make_option("dense_model_weights", all.dense_model_weights)
+               .keep()
+               .help("Store the weights of binary models as one page aligned table which is loaded with a single copy, "
+                     "or memory mapped when testing, instead of as a list of (index, weight) records"))
+      .add(make_option("save_shared_weights", all.shared_weights_output)
+               .help("Save the dense weight table to a page aligned file which can be loaded with --shared_weights"));
   options.add_and_parse(output_model_options);
 
   if (!all.final_regressor_name.empty() && !all.quiet)
@@ -1256,6 +1262,8 @@ void parse_output_model(options_i& options, VW::workspace& all)
     all.logger.err_warn("--save_resume flag is deprecated -- learning can now continue on saved models by default.");
   }
   if (predict_only_model) { all.save_resume = false; }
+  if (all.dense_model_weights && all.weights.sparse)
+  { THROW("--dense_model_weights is not supported with --sparse_weights"); }
 
   if ((options.was_supplied("invert_hash") || options.was_supplied("readable_model")) && all.save_resume)
   {
@@ -1393,15 +1401,33 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
   }
 
   bool strict_parse = false;
+  bool example_arena = false;
+  bool compact_features = false;
   int ring_size_tmp;
   int64_t example_queue_limit_tmp;
+  uint64_t example_pool_shards = 0;
+  uint64_t example_pool_high_water = 0;
   option_group_definition vw_args("Parser");
   vw_args.add(make_option("ring_size", ring_size_tmp).default_value(256).help("Size of example ring"))
       .add(make_option("example_queue_limit", example_queue_limit_tmp)
                .default_value(256)
                .help("Max number of examples to store after parsing but before the learner has processed. Rarely "
                      "needs to be changed."))
-      .add(make_option("strict_parse", strict_parse).help("Throw on malformed examples"));
+      .add(make_option("strict_parse", strict_parse).help("Throw on malformed examples"))
+      .add(make_option("example_arena", example_arena)
+               .help("Allocate the features of each example from an arena which is reset when the example is done, "
+                     "instead of growing them one by one"))
+      .add(make_option("compact_features", compact_features)
+               .help("Pack the features of each example into one contiguous array of values and one of indices once "
+                     "parsed. Implies --example_arena"))
+      .add(make_option("example_pool_shards", example_pool_shards)
+               .default_value(0)
+               .help("Number of shards of the example pool, so that threads producing and freeing examples do not "
+                     "contend on one lock. 0 uses one per hardware thread"))
+      .add(make_option("example_pool_high_water", example_pool_high_water)
+               .default_value(0)
+               .help("Free the examples returned to the pool while it holds this many unused ones already. 0 keeps "
+                     "them all"));
   all->options->add_and_parse(vw_args);
 
   if (ring_size_tmp <= 0) { THROW("ring_size should be positive") }
@@ -1420,8 +1446,12 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
     }
   }
 
-  all->example_parser = new parser{final_example_queue_limit, strict_parse};
+  all->example_parser =
+      new parser{final_example_queue_limit, strict_parse, static_cast<size_t>(example_pool_shards)};
   all->example_parser->_shared_data = all->sd;
+  all->example_parser->example_pool.set_high_water(static_cast<size_t>(example_pool_high_water));
+  all->example_parser->use_example_arena = example_arena || compact_features;
+  all->example_parser->compact_features = compact_features;
 
   option_group_definition weight_args("Weight");
   weight_args
@@ -1433,12 +1463,17 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
       .add(make_option("normal_weights", all->normal_weights).help("Make initial weights normal"))
       .add(make_option("truncated_normal_weights", all->tnormal_weights).help("Make initial weights truncated normal"))
       .add(make_option("sparse_weights", all->weights.sparse).help("Use a sparse datastructure for weights"))
+      .add(make_option("shared_weights", all->shared_weights_input)
+               .help("Map the weights read only from a file written by --save_shared_weights instead of reading them "
+                     "from the model, so that all processes serving it share one copy. Requires --testonly"))
       .add(make_option("input_feature_regularizer", all->per_feature_regularizer_input)
                .help("Per feature regularization input file"));
   all->options->add_and_parse(weight_args);
 
   std::string span_server_arg;
   int32_t span_server_port_arg;
+  bool allreduce_shm_arg = false;
+  uint64_t allreduce_shm_timeout_arg = 0;
   // bool threads_arg;
   uint64_t unique_id_arg;
   uint64_t total_arg;
@@ -1452,7 +1487,13 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
       .add(make_option("node", node_arg).default_value(0).help("Node number in cluster parallel job"))
       .add(make_option("span_server_port", span_server_port_arg)
                .default_value(26543)
-               .help("Port of the server for setting up spanning tree"));
+               .help("Port of the server for setting up spanning tree"))
+      .add(make_option("allreduce_shm", allreduce_shm_arg)
+               .help("Allreduce through shared memory between processes on this host instead of through a spanning "
+                     "tree server. Requires --unique_id, --total and --node"))
+      .add(make_option("allreduce_shm_timeout", allreduce_shm_timeout_arg)
+               .default_value(static_cast<uint64_t>(AllReduceSharedMemory::default_timeout_seconds))
+               .help("Seconds a node waits for the others in a shared memory allreduce before giving up"));
   all->options->add_and_parse(parallelization_args);
 
   // total, unique_id and node must be specified together.
@@ -1462,7 +1503,16 @@ std::unique_ptr<VW::workspace> parse_args(std::unique_ptr<options_i, options_del
           all->options->was_supplied("unique_id")))
   { THROW("unique_id, total, and node must be all be specified if any are specified.") }
 
-  if (all->options->was_supplied("span_server"))
+  if (allreduce_shm_arg)
+  {
+    if (all->options->was_supplied("span_server")) { THROW("--allreduce_shm and --span_server are mutually exclusive") }
+    if (!all->options->was_supplied("unique_id")) { THROW("--allreduce_shm requires --unique_id, --total and --node") }
+    all->all_reduce_type = AllReduceType::SharedMemory;
+    all->all_reduce = new AllReduceSharedMemory(VW::cast_to_smaller_type<size_t>(unique_id_arg),
+        VW::cast_to_smaller_type<size_t>(total_arg), VW::cast_to_smaller_type<size_t>(node_arg), all->quiet,
+        VW::cast_to_smaller_type<size_t>(allreduce_shm_timeout_arg));
+  }
+  else if (all->options->was_supplied("span_server"))
   {
     all->all_reduce_type = AllReduceType::Socket;
     all->all_reduce = new AllReduceSockets(span_server_arg, VW::cast_to_smaller_type<int>(span_server_port_arg),
@@ -1610,6 +1660,9 @@ void parse_sources(options_i& options, VW::workspace& all, io_buf& model, bool s
     model.close_file();
   }
 
+  if (!all.shared_weights_input.empty() && !all.weights.dense_weights.mapped())
+  { THROW("--shared_weights is only supported when gd is the base learner"); }
+
   auto parsed_source_options = parse_source(all, options);
   enable_sources(all, all.quiet, all.numpasses, parsed_source_options);
 
@@ -1750,6 +1803,10 @@ std::unique_ptr<VW::workspace> initialize_internal(std::unique_ptr<options_i, op
     model = &local_model;
   }
 
+  // The mapped weights replace those of a model, which must still be read for everything else it holds.
+  if (!all->shared_weights_input.empty() && model->num_input_files() == 0)
+  { THROW("--shared_weights requires the model to be given with -i"); }
+
   std::vector<std::string> dictionary_namespaces;
   try
   {
@@ -1927,11 +1984,34 @@ VW::workspace* initialize(
   return initialize_with_builder(s, model, skip_model_load, trace_listener, trace_context, nullptr);
 }
 
+VW::workspace* initialize(const resolved_setup& setup, io_buf* model, bool skip_model_load,
+    trace_message_t trace_listener, void* trace_context)
+{
+  std::unique_ptr<options_i, options_deleter_type> options(
+      new config::options_cli(setup.args), [](VW::config::options_i* ptr) { delete ptr; });
+  return initialize_with_builder(std::move(options), model, skip_model_load, trace_listener, trace_context,
+      VW::make_unique<VW::resolved_reduction_stack_setup>(setup.reductions));
+}
+
+// Points new_model at the model states of vw_model.
+void share_model_states(VW::workspace* vw_model, VW::workspace* new_model)
+{
+  free_it(new_model->sd);
+
+  // reference model states stored in the specified VW instance
+  new_model->weights.shallow_copy(vw_model->weights);  // regressor
+  new_model->sd = vw_model->sd;                        // shared data
+  new_model->example_parser->_shared_data = new_model->sd;
+}
+
 // Create a new VW instance while sharing the model with another instance
 // The extra arguments will be appended to those of the other VW instance
 VW::workspace* seed_vw_model(
     VW::workspace* vw_model, const std::string& extra_args, trace_message_t trace_listener, void* trace_context)
 {
+  if (extra_args.find_first_not_of(" \t") == std::string::npos)
+  { return clone_vw_model(vw_model, trace_listener, trace_context); }
+
   cli_options_serializer serializer;
   for (auto const& option : vw_model->options->get_all_options())
   {
@@ -1950,13 +2030,35 @@ VW::workspace* seed_vw_model(
 
   VW::workspace* new_model =
       VW::initialize(serialized_options, nullptr, true /* skip_model_load */, trace_listener, trace_context);
-  free_it(new_model->sd);
+  share_model_states(vw_model, new_model);
+  return new_model;
+}
 
-  // reference model states stored in the specified VW instance
-  new_model->weights.shallow_copy(vw_model->weights);  // regressor
-  new_model->sd = vw_model->sd;                        // shared data
-  new_model->example_parser->_shared_data = new_model->sd;
+VW::workspace* clone_vw_model(VW::workspace* vw_model, trace_message_t trace_listener, void* trace_context)
+{
+  return clone_vw_model(vw_model, resolve_setup(*vw_model), trace_listener, trace_context);
+}
 
+VW::workspace* clone_vw_model(
+    VW::workspace* vw_model, const resolved_setup& setup, trace_message_t trace_listener, void* trace_context)
+{
+  // Same as seed_vw_model, no_stdin is added by vw::initialize and -i would reload the model.
+  resolved_setup clone_setup;
+  clone_setup.reductions = setup.reductions;
+  for (size_t i = 0; i < setup.args.size(); i++)
+  {
+    if (setup.args[i] == "--no_stdin") { continue; }
+    if (setup.args[i] == "--initial_regressor")
+    {
+      i++;
+      continue;
+    }
+    clone_setup.args.push_back(setup.args[i]);
+  }
+
+  VW::workspace* new_model =
+      VW::initialize(clone_setup, nullptr, true /* skip_model_load */, trace_listener, trace_context);
+  share_model_states(vw_model, new_model);
   return new_model;
 }
 
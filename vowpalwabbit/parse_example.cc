@@ -18,6 +18,10 @@
 
 #include <cctype>
 #include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
 
 size_t read_features(io_buf& buf, char*& line, size_t& num_chars)
 {
@@ -78,9 +82,25 @@ public:
   uint64_t _parse_mask;
   std::array<std::vector<std::shared_ptr<feature_dict>>, NUM_NAMESPACES>* _namespace_dictionaries;
   VW::io::logger* logger;
+  std::shared_ptr<const std::string> _audit_source;
 
   ~TC_parser() {}
 
+  // A space followed by the line, which the lazy audit strings of its features refer to.
+  const std::shared_ptr<const std::string>& audit_source()
+  {
+    if (_audit_source == nullptr) { _audit_source = std::make_shared<const std::string>(" " + std::string{_line}); }
+    return _audit_source;
+  }
+
+  // Offset of s in audit_source(). The name of the default namespace is the literal space, found at its front.
+  uint32_t audit_begin(VW::string_view s) const
+  {
+    const std::less_equal<const char*> before;
+    if (!before(_line.data(), s.data()) || !before(s.data(), _line.data() + _line.size())) { return 0; }
+    return static_cast<uint32_t>(s.data() - _line.data()) + 1;
+  }
+
   // TODO: Currently this function is called by both warning and error conditions. We only log
   //      to warning here though.
   inline FORCE_INLINE void parserWarning(const char* message, VW::string_view var_msg, const char* message2,
@@ -223,15 +243,19 @@ public:
 
       if (audit)
       {
-        if (!string_feature_value.empty())
+        // The strings are only built if they are read, --invert_hash for instance reads those of new features only.
+        // Lines too long for the offsets of lazy_audit_strings get them right away.
+        if (_line.size() < std::numeric_limits<uint32_t>::max())
         {
-          std::stringstream ss;
-          fs.space_names.push_back(
-              VW::audit_strings(std::string{_base}, std::string{feature_name}, std::string{string_feature_value}));
+          fs.space_names.push_back_lazy(audit_source(),
+              {audit_begin(_base), static_cast<uint32_t>(_base.size()), audit_begin(feature_name),
+                  static_cast<uint32_t>(feature_name.size()), audit_begin(string_feature_value),
+                  static_cast<uint32_t>(string_feature_value.size())});
         }
         else
         {
-          fs.space_names.push_back(VW::audit_strings(std::string{_base}, std::string{feature_name}));
+          fs.space_names.push_back(
+              VW::audit_strings(std::string{_base}, std::string{feature_name}, std::string{string_feature_value}));
         }
       }
 
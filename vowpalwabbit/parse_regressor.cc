@@ -10,6 +10,8 @@
 #include <iostream>
 
 #ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/stat.h>
 #  include <unistd.h>
 #endif
 
@@ -21,6 +23,7 @@
 #include "shared_data.h"
 #include "vw/common/vw_exception.h"
 #include "vw/config/cli_options_serializer.h"
+#include "vw/io/io_adapter.h"
 #include "vw/io/logger.h"
 #include "vw_validate.h"
 #include "vw_versions.h"
@@ -492,10 +495,110 @@ void save_predictor(VW::workspace& all, const std::string& reg_name, size_t curr
   dump_regressor(all, filename.str(), false);
 }
 
+namespace
+{
+// Layout of a --save_shared_weights file. The raw dense weight table starts at data_offset, which is aligned to 64KiB
+// so that it is a valid mmap offset for any page size.
+struct shared_weights_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t num_bits;
+  uint32_t stride_shift;
+  uint32_t reserved;
+  uint64_t data_offset;
+  uint64_t weight_count;
+};
+
+constexpr char SHARED_WEIGHTS_MAGIC[8] = {'V', 'W', 'S', 'H', 'W', 'T', 'S', '\0'};
+constexpr uint32_t SHARED_WEIGHTS_VERSION = 1;
+constexpr uint64_t SHARED_WEIGHTS_ALIGNMENT = static_cast<uint64_t>(1) << 16;
+
+void write_all(VW::io::writer& writer, const char* buffer, size_t num_bytes)
+{
+  while (num_bytes > 0)
+  {
+    auto written = writer.write(buffer, num_bytes);
+    if (written <= 0) { THROW("Failed to write shared weights"); }
+    buffer += written;
+    num_bytes -= static_cast<size_t>(written);
+  }
+}
+}  // namespace
+
+void save_shared_weights(VW::workspace& all, const std::string& filename)
+{
+  if (all.weights.sparse) { THROW("--save_shared_weights is not supported with --sparse_weights"); }
+  auto& weights = all.weights.dense_weights;
+
+  shared_weights_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SHARED_WEIGHTS_MAGIC, sizeof(header.magic));
+  header.version = SHARED_WEIGHTS_VERSION;
+  header.num_bits = all.num_bits;
+  header.stride_shift = weights.stride_shift();
+  header.data_offset = SHARED_WEIGHTS_ALIGNMENT;
+  header.weight_count = weights.mask() + 1;
+
+  std::string start_name = filename + std::string(".writing");
+  {
+    auto writer = VW::io::open_file_writer(start_name);
+    write_all(*writer, reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<char> padding(static_cast<size_t>(header.data_offset) - sizeof(header), 0);
+    write_all(*writer, padding.data(), padding.size());
+    write_all(*writer, reinterpret_cast<const char*>(weights.first()),
+        static_cast<size_t>(header.weight_count) * sizeof(weight));
+  }
+
+  remove(filename.c_str());
+  if (0 != rename(start_name.c_str(), filename.c_str()))
+  { THROW("save_shared_weights: cannot rename: " << start_name << " to " << filename); }
+}
+
+void load_shared_weights(VW::workspace& all, const std::string& filename)
+{
+#ifdef _WIN32
+  _UNUSED(all);
+  THROW("--shared_weights is not supported on Windows");
+#else
+  if (all.weights.sparse) { THROW("--shared_weights is not supported with --sparse_weights"); }
+  auto& weights = all.weights.dense_weights;
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) { THROWERRNO("open(" << filename << ")"); }
+  std::unique_ptr<int, void (*)(int*)> fd_closer(&fd, [](int* f) { close(*f); });
+
+  shared_weights_header header;
+  if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+      memcmp(header.magic, SHARED_WEIGHTS_MAGIC, sizeof(header.magic)) != 0)
+  { THROW(filename << " is not a shared weights file, create one with --save_shared_weights"); }
+  if (header.version != SHARED_WEIGHTS_VERSION)
+  { THROW(filename << " has unsupported shared weights version " << header.version); }
+  if (header.num_bits != all.num_bits)
+  { THROW(filename << " was saved with " << header.num_bits << " bits but the model uses " << all.num_bits); }
+  if (header.stride_shift != weights.stride_shift())
+  {
+    THROW(filename << " was saved with a stride of " << (1 << header.stride_shift) << " but the model uses "
+                   << weights.stride());
+  }
+  if (header.weight_count != (static_cast<uint64_t>(all.length()) << header.stride_shift) ||
+      header.data_offset % SHARED_WEIGHTS_ALIGNMENT != 0)
+  { THROW(filename << " has a corrupted header"); }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) { THROWERRNO("fstat(" << filename << ")"); }
+  if (static_cast<uint64_t>(info.st_size) < header.data_offset + header.weight_count * sizeof(weight))
+  { THROW(filename << " is truncated"); }
+
+  weights.map_read_only(fd, header.data_offset, all.length(), header.stride_shift);
+#endif
+}
+
 void finalize_regressor(VW::workspace& all, const std::string& reg_name)
 {
   if (!all.early_terminate)
   {
+    if (!all.shared_weights_output.empty()) { save_shared_weights(all, all.shared_weights_output); }
     if (all.per_feature_regularizer_output.length() > 0)
     { dump_regressor(all, all.per_feature_regularizer_output, false); }
     else
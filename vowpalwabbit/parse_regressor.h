@@ -12,6 +12,10 @@ void read_regressor_file(VW::workspace& all, const std::vector<std::string>& fil
 void finalize_regressor(VW::workspace& all, const std::string& reg_name);
 void initialize_regressor(VW::workspace& all);
 
+// Dense weight table in a page aligned file which can be mapped read only by any number of serving processes.
+void save_shared_weights(VW::workspace& all, const std::string& filename);
+void load_shared_weights(VW::workspace& all, const std::string& filename);
+
 void save_predictor(VW::workspace& all, const std::string& reg_name, size_t current_pass);
 void save_load_header(VW::workspace& all, io_buf& model_file, bool read, bool text, std::string& file_options,
     VW::config::options_i& options);
@@ -92,8 +92,8 @@ bool got_sigterm;
 
 void handle_sigterm(int) { got_sigterm = true; }
 
-parser::parser(size_t example_queue_limit, bool strict_parse_)
-    : example_pool{example_queue_limit}
+parser::parser(size_t example_queue_limit, bool strict_parse_, size_t example_pool_shards)
+    : example_pool{example_queue_limit, example_pool_shards}
     , ready_parsed_examples{example_queue_limit}
     , example_queue_limit{example_queue_limit}
     , num_examples_taken_from_pool(0)
@@ -693,6 +693,7 @@ VW::example& get_unused_example(VW::workspace* all)
 {
   parser* p = all->example_parser;
   auto* ex = p->example_pool.get_object();
+  if (p->use_example_arena && ex->arena == nullptr) { VW::attach_example_arena(*ex); }
   ex->example_counter = static_cast<size_t>(p->num_examples_taken_from_pool.fetch_add(1, std::memory_order_relaxed));
   return *ex;
 }
@@ -771,6 +772,9 @@ void setup_example(VW::workspace& all, VW::example* ae)
 
   if (!all.limit_strings.empty()) { feature_limit(all, ae); }
 
+  // Once no more features are added, so that the loops over them below and in the learners walk contiguous memory.
+  if (all.example_parser->compact_features && ae->arena != nullptr) { VW::compact_example_features(*ae); }
+
   uint64_t multiplier = static_cast<uint64_t>(all.wpp) << all.weights.stride_shift();
 
   if (multiplier != 1)
@@ -892,6 +896,7 @@ void parse_example_label(VW::workspace& all, example& ec, const std::string& lab
 
 void empty_example(VW::workspace& /*all*/, example& ec)
 {
+  if (ec.arena != nullptr) { VW::reset_example_arena(ec); }
   for (features& fs : ec) { fs.clear(); }
 
   ec.indices.clear();
@@ -54,7 +54,7 @@ struct dsjson_metrics;
 
 struct parser
 {
-  parser(size_t example_queue_limit, bool strict_parse_);
+  parser(size_t example_queue_limit, bool strict_parse_, size_t example_pool_shards = 0);
 
   // delete copy constructor
   parser(const parser&) = delete;
@@ -63,7 +63,7 @@ struct parser
   // helper(s) for text parsing
   std::vector<VW::string_view> words;
 
-  VW::object_pool<VW::example> example_pool;
+  VW::sharded_object_pool<VW::example> example_pool;
   VW::ptr_queue<VW::example> ready_parsed_examples;
 
   io_buf input;  // Input source(s)
@@ -114,6 +114,8 @@ struct parser
   bool decision_service_json = false;
 
   bool strict_parse;
+  bool use_example_arena = false;  // examples from the pool keep their features in an example_arena
+  bool compact_features = false;   // and packed, see VW::compact_example_features
   std::exception_ptr exc_ptr;
   std::unique_ptr<dsjson_metrics> metrics = nullptr;
 };
@@ -0,0 +1,94 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "predict_context.h"
+
+#include "global_data.h"
+#include "io_buf.h"
+#include "named_labels.h"
+#include "shared_data.h"
+#include "vw.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/options.h"
+#include "vw/io/io_adapter.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace VW::config;
+
+namespace
+{
+// Options that make a workspace read examples or write files on its own, which a context must not do.
+const std::set<std::string> IGNORED_OPTIONS = {"cache", "cache_file", "daemon", "data",
+    "dump_json_weights_experimental", "extra_metrics", "final_regressor", "foreground", "initial_regressor",
+    "input_feature_regularizer", "invert_hash", "kill_cache", "no_stdin", "node", "num_children",
+    "output_feature_regularizer_binary", "output_feature_regularizer_text", "pid_file", "port", "port_file",
+    "predictions", "raw_predictions", "readable_model", "save_per_pass", "span_server", "total", "unique_id"};
+
+VW::resolved_setup context_setup(VW::workspace& model, const VW::resolved_setup& setup)
+{
+  VW::resolved_setup context;
+  context.reductions = setup.reductions;
+  for (size_t i = 0; i < setup.args.size(); i++)
+  {
+    const auto& token = setup.args[i];
+    // Positional arguments come last, they are data files.
+    if (token.compare(0, 2, "--") != 0) { break; }
+
+    const auto name = token.substr(2);
+    const bool has_value = dynamic_cast<const typed_option<bool>*>(model.options->get_option(name).get()) == nullptr;
+    if (IGNORED_OPTIONS.count(name) == 0)
+    {
+      context.args.push_back(token);
+      if (has_value && i + 1 < setup.args.size()) { context.args.push_back(setup.args[i + 1]); }
+    }
+    if (has_value) { i++; }
+  }
+
+  for (const std::string flag : {"--testonly", "--quiet"})
+  {
+    if (std::find(context.args.begin(), context.args.end(), flag) == context.args.end())
+    { context.args.push_back(flag); }
+  }
+  return context;
+}
+}  // namespace
+
+namespace VW
+{
+predict_context::predict_context(VW::workspace& model) : predict_context(model, resolve_setup(model)) {}
+
+predict_context::predict_context(VW::workspace& model, const resolved_setup& setup)
+{
+  if (model.weights.sparse) { THROW("predict_context requires dense weights"); }
+
+  // The model is loaded for the reduction state kept outside of the weights, such as trees or learned baselines.
+  auto model_bytes = std::make_shared<std::vector<char>>();
+  io_buf model_writer;
+  model_writer.add_file(VW::io::create_vector_writer(model_bytes));
+  VW::save_predictor(model, model_writer);
+
+  io_buf model_reader;
+  model_reader.add_file(VW::io::create_buffer_view(model_bytes->data(), model_bytes->size()));
+  _workspace = VW::initialize(context_setup(model, setup), &model_reader);
+  _shared_data.reset(_workspace->sd);
+
+  // Drops the weights just loaded for the ones of the model.
+  _workspace->weights.shallow_copy(model.weights);
+}
+
+predict_context::~predict_context() { VW::finish(*_workspace); }
+
+VW::example* predict_context::read_example(const std::string& line) { return VW::read_example(*_workspace, line); }
+
+void predict_context::predict(VW::example& ec) { _workspace->predict(ec); }
+
+void predict_context::predict(VW::multi_ex& ec) { _workspace->predict(ec); }
+
+void predict_context::finish_example(VW::example& ec) { VW::finish_example(*_workspace, ec); }
+
+void predict_context::finish_example(VW::multi_ex& ec) { VW::finish_example(*_workspace, ec); }
+}  // namespace VW
@@ -0,0 +1,47 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "resolved_setup.h"
+#include "vw_fwd.h"
+
+#include <memory>
+#include <string>
+
+struct shared_data;
+
+namespace VW
+{
+// Predicts with the model of a workspace from a thread of its own.
+//
+// Reductions and shared data write scratch state on every call, so a workspace cannot predict from several threads at
+// once. A context is a workspace of its own, set up from the resolved setup of the model and loaded with a copy of its
+// reduction state, that shares the weights of the model only. Contexts never write to the weights, so the contexts of a
+// model may predict concurrently as long as the model does not learn meanwhile. Create them one at a time, as the model
+// is saved to load each of them. Requires dense weights, since reading missing sparse weights inserts them.
+class predict_context
+{
+public:
+  explicit predict_context(VW::workspace& model);
+  predict_context(VW::workspace& model, const resolved_setup& setup);
+  ~predict_context();
+
+  predict_context(const predict_context&) = delete;
+  predict_context& operator=(const predict_context&) = delete;
+
+  VW::example* read_example(const std::string& line);
+  void predict(VW::example& ec);
+  void predict(VW::multi_ex& ec);
+  void finish_example(VW::example& ec);
+  void finish_example(VW::multi_ex& ec);
+
+  VW::workspace& get_workspace() { return *_workspace; }
+
+private:
+  VW::workspace* _workspace = nullptr;
+  // Owned here, the workspace does not delete its shared data as its weights are not its own.
+  std::unique_ptr<shared_data> _shared_data;
+};
+}  // namespace VW
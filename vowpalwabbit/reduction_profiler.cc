@@ -0,0 +1,217 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "reduction_profiler.h"
+
+#include "learner.h"
+#include "memory.h"
+#include "metric_sink.h"
+#include "scope_exit.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+using namespace VW::LEARNER;
+
+namespace VW
+{
+struct reduction_profiler::layer
+{
+  layer(reduction_profiler& profiler, std::string name) : profiler(profiler), name(std::move(name)) {}
+
+  template <typename CallT>
+  void time(operation op, CallT call)
+  {
+    uint64_t& children_ns = profiler._children_ns;
+    const uint64_t outer_children_ns = children_ns;
+    children_ns = 0;
+    const auto start = std::chrono::steady_clock::now();
+    // Also recorded when the call throws, so the time of the calls above stays consistent.
+    auto record_guard = VW::scope_exit([&]() {
+      const auto elapsed_ns = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+      op_stats[static_cast<size_t>(op)].record(elapsed_ns, elapsed_ns > children_ns ? elapsed_ns - children_ns : 0);
+      children_ns = outer_children_ns + elapsed_ns;
+    });
+    call();
+  }
+
+  reduction_profiler& profiler;
+  std::string name;
+  LEARNER::details::learn_data original;
+  LEARNER::details::finish_example_data original_finish;
+  std::array<stats, NUM_OPERATIONS> op_stats;
+};
+}  // namespace VW
+
+namespace
+{
+using layer = VW::reduction_profiler::layer;
+using operation = VW::reduction_profiler::operation;
+
+void profiled_learn(void* data, base_learner& base, void* ec)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.time(operation::learn, [&]() { l.original.learn_f(l.original.data, base, ec); });
+}
+
+void profiled_predict(void* data, base_learner& base, void* ec)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.time(operation::predict, [&]() { l.original.predict_f(l.original.data, base, ec); });
+}
+
+void profiled_update(void* data, base_learner& base, void* ec)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.time(operation::update, [&]() { l.original.update_f(l.original.data, base, ec); });
+}
+
+void profiled_multipredict(void* data, base_learner& base, void* ec, size_t count, size_t step,
+    VW::polyprediction* pred, bool finalize_predictions)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.time(operation::multipredict,
+      [&]() { l.original.multipredict_f(l.original.data, base, ec, count, step, pred, finalize_predictions); });
+}
+
+void profiled_finish_example(VW::workspace& all, void* data, void* ec)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.time(operation::finish_example,
+      [&]() { l.original_finish.finish_example_f(all, l.original_finish.data, ec); });
+}
+
+// print_example shares its data with finish_example, so it is forwarded as well.
+void forward_print_example(VW::workspace& all, void* data, void* ec)
+{
+  auto& l = *static_cast<layer*>(data);
+  l.original_finish.print_example_f(all, l.original_finish.data, ec);
+}
+
+const char* operation_name(operation op)
+{
+  switch (op)
+  {
+    case operation::learn:
+      return "learn";
+    case operation::predict:
+      return "predict";
+    case operation::multipredict:
+      return "multipredict";
+    case operation::update:
+      return "update";
+    case operation::finish_example:
+      return "finish_example";
+  }
+  return "unknown";
+}
+}  // namespace
+
+namespace VW
+{
+void reduction_profiler::stats::record(uint64_t elapsed_ns, uint64_t self_elapsed_ns)
+{
+  calls++;
+  total_ns += elapsed_ns;
+  self_ns += self_elapsed_ns;
+  if (elapsed_ns > max_ns) { max_ns = elapsed_ns; }
+
+  size_t bucket = 0;
+  while (bucket < NUM_BUCKETS - 1 && (elapsed_ns >> bucket) != 0) { bucket++; }
+  histogram[bucket]++;
+}
+
+uint64_t reduction_profiler::stats::percentile_ns(double quantile) const
+{
+  const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(calls));
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < NUM_BUCKETS - 1; bucket++)
+  {
+    seen += histogram[bucket];
+    if (seen > rank) { return std::min(uint64_t(1) << bucket, max_ns); }
+  }
+  return max_ns;
+}
+
+reduction_profiler::reduction_profiler() = default;
+reduction_profiler::~reduction_profiler() = default;
+
+void reduction_profiler::instrument(base_learner& top)
+{
+  std::map<std::string, size_t> name_counts;
+  for (base_learner* l = top.learn_fd.base; l != nullptr; l = l->learn_fd.base)
+  {
+    std::string name = l->name;
+    const size_t count = ++name_counts[name];
+    if (count > 1) { name += "_" + std::to_string(count); }
+
+    _layers.push_back(VW::make_unique<layer>(*this, std::move(name)));
+    layer& instrumented = *_layers.back();
+    instrumented.original = l->learn_fd;
+    l->learn_fd.data = &instrumented;
+    l->learn_fd.learn_f = profiled_learn;
+    l->learn_fd.predict_f = profiled_predict;
+    if (l->learn_fd.update_f != nullptr) { l->learn_fd.update_f = profiled_update; }
+    if (l->learn_fd.multipredict_f != nullptr) { l->learn_fd.multipredict_f = profiled_multipredict; }
+  }
+
+  // Reductions which do not implement finish_example copy the one of their base, so it is implemented by the lowest
+  // learner of the run sharing the one of top.
+  layer* finish_owner = nullptr;
+  size_t depth = 0;
+  for (base_learner* l = top.learn_fd.base; l != nullptr; l = l->learn_fd.base, depth++)
+  {
+    if (l->finish_example_fd.data != top.finish_example_fd.data ||
+        l->finish_example_fd.finish_example_f != top.finish_example_fd.finish_example_f)
+    { break; }
+    finish_owner = _layers[depth].get();
+  }
+  if (finish_owner != nullptr && top.finish_example_fd.finish_example_f != nullptr)
+  {
+    finish_owner->original_finish = top.finish_example_fd;
+    top.finish_example_fd.data = finish_owner;
+    top.finish_example_fd.finish_example_f = profiled_finish_example;
+    if (top.finish_example_fd.print_example_f != nullptr)
+    { top.finish_example_fd.print_example_f = forward_print_example; }
+  }
+}
+
+void reduction_profiler::persist_metrics(metric_sink& metrics) const
+{
+  for (const auto& l : _layers)
+  {
+    for (size_t op = 0; op < NUM_OPERATIONS; op++)
+    {
+      const auto& s = l->op_stats[op];
+      if (s.calls == 0) { continue; }
+
+      const std::string prefix = "profile." + l->name + "." + operation_name(static_cast<operation>(op)) + ".";
+      metrics.set_uint(prefix + "calls", s.calls);
+      metrics.set_uint(prefix + "total_ns", s.total_ns);
+      metrics.set_uint(prefix + "self_ns", s.self_ns);
+      metrics.set_uint(prefix + "p50_ns", s.percentile_ns(0.5));
+      metrics.set_uint(prefix + "p90_ns", s.percentile_ns(0.9));
+      metrics.set_uint(prefix + "p99_ns", s.percentile_ns(0.99));
+      metrics.set_uint(prefix + "max_ns", s.max_ns);
+      for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+      {
+        if (s.histogram[bucket] == 0) { continue; }
+        const std::string bound = bucket < NUM_BUCKETS - 1 ? std::to_string(uint64_t(1) << bucket) : "inf";
+        metrics.set_uint(prefix + "histogram.lt_" + bound + "_ns", s.histogram[bucket]);
+      }
+    }
+  }
+}
+
+const reduction_profiler::stats* reduction_profiler::get_stats(const std::string& learner_name, operation op) const
+{
+  for (const auto& l : _layers)
+  {
+    if (l->name == learner_name) { return &l->op_stats[static_cast<size_t>(op)]; }
+  }
+  return nullptr;
+}
+}  // namespace VW
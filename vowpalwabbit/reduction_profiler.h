@@ -0,0 +1,77 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "vw_fwd.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VW
+{
+struct metric_sink;
+
+// Times the calls made to each learner of a reduction stack, for --profile_reductions.
+//
+// Every call is counted with its total time, which includes the learners below, and its self time, which does not.
+// Total times also go into a histogram of power of two buckets, from which latency percentiles are reported. A learner
+// which is not instrumented costs nothing, an instrumented one two clock reads per call.
+class reduction_profiler
+{
+public:
+  enum class operation
+  {
+    learn,
+    predict,
+    multipredict,
+    update,
+    finish_example
+  };
+
+  static constexpr size_t NUM_OPERATIONS = 5;
+  static constexpr size_t NUM_BUCKETS = 40;  // bucket i counts the calls which took less than 2^i ns
+
+  struct stats
+  {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t self_ns = 0;
+    uint64_t max_ns = 0;
+    std::array<uint64_t, NUM_BUCKETS> histogram{};
+
+    void record(uint64_t elapsed_ns, uint64_t self_elapsed_ns);
+    // Upper bound of the bucket holding the given quantile of the calls.
+    uint64_t percentile_ns(double quantile) const;
+  };
+
+  struct layer;
+
+  reduction_profiler();
+  ~reduction_profiler();
+
+  reduction_profiler(const reduction_profiler&) = delete;
+  reduction_profiler& operator=(const reduction_profiler&) = delete;
+
+  // Instruments every learner below top, down to the base learner. The finish_example top forwards to is timed too,
+  // and attributed to the learner which implements it. Must be called once top is built, since reductions copy the
+  // functions of their base when they are built.
+  void instrument(LEARNER::base_learner& top);
+
+  // Adds profile.<learner>.<operation>.<statistic> metrics for every operation which was called at least once.
+  void persist_metrics(metric_sink& metrics) const;
+
+  // Statistics of the instrumented learner with this name, or nullptr. A name which appears several times in the
+  // stack is suffixed with _2, _3 and so on from the top.
+  const stats* get_stats(const std::string& learner_name, operation op) const;
+
+private:
+  std::vector<std::unique_ptr<layer>> _layers;
+  // Time spent in the instrumented calls made by the call currently being timed.
+  uint64_t _children_ns = 0;
+};
+}  // namespace VW
@@ -4,6 +4,7 @@
 #include "global_data.h"  // to get vw struct
 #include "learner.h"
 #include "simple_label_parser.h"
+#include "vw/common/vw_exception.h"
 #include "vw/config/options.h"
 #include "vw/config/options_name_extractor.h"
 #include "vw_fwd.h"
@@ -25,6 +26,7 @@
 #include "reductions/cats_tree.h"
 #include "reductions/cb/cb_adf.h"
 #include "reductions/cb/cb_algs.h"
+#include "reductions/cb/cb_candidates.h"
 #include "reductions/cb/cb_dro.h"
 #include "reductions/cb/cb_explore.h"
 #include "reductions/cb/cb_explore_adf_bag.h"
@@ -54,6 +56,7 @@
 #include "reductions/expreplay.h"
 #include "reductions/freegrad.h"
 #include "reductions/ftrl.h"
+#include "reductions/fused_stacks.h"
 #include "reductions/gd.h"
 #include "reductions/gd_mf.h"
 #include "reductions/generate_interactions.h"
@@ -76,6 +79,7 @@
 #include "reductions/oaa.h"
 #include "reductions/offset_tree.h"
 #include "reductions/oja_newton.h"
+#include "reductions/parameter_server.h"
 #include "reductions/plt.h"
 #include "reductions/pmf_to_pdf.h"
 #include "reductions/print.h"
@@ -90,6 +94,9 @@
 #include "reductions/svrg.h"
 #include "reductions/topk.h"
 
+#include <algorithm>
+#include <set>
+
 void register_reductions(std::vector<reduction_setup_fn>& reductions,
     std::vector<std::tuple<std::string, reduction_setup_fn>>& reduction_stack)
 {
@@ -101,7 +108,8 @@ void register_reductions(std::vector<reduction_setup_fn>& reductions,
       {VW::reductions::cb_explore_adf_regcb_setup, "cb_explore_adf_regcb"},
       {VW::reductions::shared_feature_merger_setup, "shared_feature_merger"},
       {VW::reductions::generate_interactions_setup, "generate_interactions"},
-      {VW::reductions::count_label_setup, "count_label"}, {VW::reductions::cb_to_cb_adf_setup, "cb_to_cbadf"}};
+      {VW::reductions::count_label_setup, "count_label"}, {VW::reductions::cb_to_cb_adf_setup, "cb_to_cbadf"},
+      {VW::reductions::fused_stacks_setup, "fused_stacks"}};
 
   auto name_extractor = VW::config::options_name_extractor();
   VW::workspace dummy_all(VW::io::create_null_logger());
@@ -122,7 +130,7 @@ void register_reductions(std::vector<reduction_setup_fn>& reductions,
   }
 }
 
-void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>& reduction_stack)
+std::vector<std::tuple<std::string, reduction_setup_fn>> registered_reductions()
 {
   std::vector<reduction_setup_fn> reductions;
 
@@ -138,6 +146,7 @@ void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>
   reductions.push_back(VW::reductions::noop_setup);
   reductions.push_back(VW::reductions::bfgs_setup);
   reductions.push_back(VW::reductions::oja_newton_setup);
+  reductions.push_back(VW::reductions::parameter_server_setup);
 
   reductions.push_back(VW::reductions::mf_setup);
 
@@ -156,6 +165,7 @@ void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>
   reductions.push_back(VW::reductions::lrqfa_setup);
   reductions.push_back(VW::reductions::stagewise_poly_setup);
   reductions.push_back(VW::reductions::scorer_setup);
+  reductions.push_back(VW::reductions::fused_stacks_setup);
   reductions.push_back(VW::reductions::lda_setup);
   reductions.push_back(VW::reductions::cbzo_setup);
 
@@ -200,6 +210,7 @@ void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>
   reductions.push_back(VW::reductions::cb_sample_setup);
   reductions.push_back(VW::reductions::explore_eval_setup);
   reductions.push_back(VW::reductions::shared_feature_merger_setup);
+  reductions.push_back(VW::reductions::cb_candidates_setup);
   reductions.push_back(VW::reductions::ccb_explore_adf_setup);
   reductions.push_back(VW::reductions::slates_setup);
   // cbify/warm_cb can generate multi-examples. Merge shared features after them
@@ -220,7 +231,17 @@ void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>
   reductions.push_back(VW::reductions::metrics_setup);
   reductions.push_back(VW::reductions::count_label_setup);
 
+  std::vector<std::tuple<std::string, reduction_setup_fn>> reduction_stack;
   register_reductions(reductions, reduction_stack);
+  return reduction_stack;
+}
+
+void prepare_reductions(std::vector<std::tuple<std::string, reduction_setup_fn>>& reduction_stack)
+{
+  // Naming the setup functions runs each of them against a throwaway workspace. The outcome never changes, so it is
+  // computed once per process rather than on every initialize.
+  static const auto registered = registered_reductions();
+  reduction_stack = registered;
 }
 
 namespace VW
@@ -266,6 +287,7 @@ VW::LEARNER::base_learner* default_reduction_stack_setup::setup_base_learner()
     if (base == nullptr) { return this->setup_base_learner(); }
     else
     {
+      all_ptr->enabled_setup_functions.push_back(setup_func_name);
       reduction_stack.clear();
       return base;
     }
@@ -278,4 +300,30 @@ std::string default_reduction_stack_setup::get_setupfn_name(reduction_setup_fn s
 {
   return all_ptr->get_setupfn_name(setup);
 }
+
+resolved_reduction_stack_setup::resolved_reduction_stack_setup(std::vector<std::string> enabled_setup_functions)
+    : _enabled_setup_functions(std::move(enabled_setup_functions))
+{
+}
+
+void resolved_reduction_stack_setup::delayed_state_attach(VW::workspace& all, VW::config::options_i& options)
+{
+  // Names are registered for the whole stack first, reductions may look up the names of the ones they build upon.
+  default_reduction_stack_setup::delayed_state_attach(all, options);
+
+  const std::set<std::string> enabled(_enabled_setup_functions.begin(), _enabled_setup_functions.end());
+  std::set<std::string> found;
+  auto is_disabled = [&](const std::tuple<std::string, reduction_setup_fn>& setup) {
+    if (enabled.count(std::get<0>(setup)) == 0) { return true; }
+    found.insert(std::get<0>(setup));
+    return false;
+  };
+  reduction_stack.erase(
+      std::remove_if(reduction_stack.begin(), reduction_stack.end(), is_disabled), reduction_stack.end());
+
+  for (const auto& name : enabled)
+  {
+    if (found.count(name) == 0) { THROW("resolved setup enables unknown reduction: " << name); }
+  }
+}
 }  // namespace VW
@@ -3,6 +3,7 @@
 #include "setup_base.h"
 #include "vw_fwd.h"
 
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -36,4 +37,16 @@ private:
 protected:
   std::vector<std::tuple<std::string, reduction_setup_fn>> reduction_stack;
 };
+
+// Builds the stack out of the setup functions a previous setup enabled only, see resolved_setup.h. The setup functions
+// of every other reduction are not called, so the options they define are not known to the workspace.
+struct resolved_reduction_stack_setup : public default_reduction_stack_setup
+{
+  explicit resolved_reduction_stack_setup(std::vector<std::string> enabled_setup_functions);
+
+  void delayed_state_attach(VW::workspace& all, VW::config::options_i& options) override;
+
+private:
+  std::vector<std::string> _enabled_setup_functions;
+};
 }  // namespace VW
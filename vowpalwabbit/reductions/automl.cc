@@ -12,7 +12,9 @@
 #include "vw.h"
 #include "vw/config/options.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <iterator>
 
 using namespace VW::config;
 using namespace VW::LEARNER;
@@ -184,53 +186,98 @@ void interaction_config_manager::gen_quadratic_interactions(uint64_t live_slot)
 {
   auto& exclusions = configs[scores[live_slot].config_index].exclusions;
   auto& interactions = scores[live_slot].live_interactions;
-  if (!interactions.empty()) { interactions.clear(); }
+  // Existing interactions are overwritten in place so their storage is reused.
+  size_t num_interactions = 0;
   for (auto it = ns_counter.begin(); it != ns_counter.end(); ++it)
   {
     auto idx1 = (*it).first;
+    auto excluded = exclusions.find(idx1);
+    const std::set<namespace_index>* excluded_with = excluded == exclusions.end() ? nullptr : &excluded->second;
     for (auto jt = it; jt != ns_counter.end(); ++jt)
     {
       auto idx2 = (*jt).first;
-      if (exclusions.find(idx1) == exclusions.end() || exclusions.at(idx1).find(idx2) == exclusions.at(idx1).end())
-      { interactions.push_back({idx1, idx2}); }
+      if (excluded_with != nullptr && excluded_with->count(idx2) != 0) { continue; }
+      if (num_interactions < interactions.size()) { interactions[num_interactions] = {idx1, idx2}; }
+      else
+      {
+        interactions.push_back({idx1, idx2});
+      }
+      ++num_interactions;
+    }
+  }
+  interactions.resize(num_interactions);
+}
+
+// Adds the interactions involving newly seen namespaces to a live_slot, without regenerating the ones it already
+// has. Both lists are in the order gen_quadratic_interactions produces, so merging them gives the same result.
+void interaction_config_manager::add_quadratic_interactions(
+    uint64_t live_slot, const std::array<bool, NUM_NAMESPACES>& is_new_ns)
+{
+  auto& exclusions = configs[scores[live_slot].config_index].exclusions;
+  auto& interactions = scores[live_slot].live_interactions;
+  new_interactions.clear();
+  for (auto it = ns_counter.begin(); it != ns_counter.end(); ++it)
+  {
+    auto idx1 = (*it).first;
+    auto excluded = exclusions.find(idx1);
+    const std::set<namespace_index>* excluded_with = excluded == exclusions.end() ? nullptr : &excluded->second;
+    for (auto jt = it; jt != ns_counter.end(); ++jt)
+    {
+      auto idx2 = (*jt).first;
+      if (!is_new_ns[idx1] && !is_new_ns[idx2]) { continue; }
+      if (excluded_with == nullptr || excluded_with->count(idx2) == 0) { new_interactions.push_back({idx1, idx2}); }
     }
   }
+  if (new_interactions.empty()) { return; }
+
+  interaction_vec_t merged;
+  merged.reserve(interactions.size() + new_interactions.size());
+  std::merge(std::make_move_iterator(interactions.begin()), std::make_move_iterator(interactions.end()),
+      std::make_move_iterator(new_interactions.begin()), std::make_move_iterator(new_interactions.end()),
+      std::back_inserter(merged));
+  interactions.swap(merged);
 }
 
 // This function will process an incoming multi_ex, update the namespace_counter,
-// log if new namespaces are encountered, and regenerate interactions based on
-// newly seen namespaces.
+// log if new namespaces are encountered, and add the interactions of newly seen
+// namespaces.
 void interaction_config_manager::pre_process(const multi_ex& ecs)
 {
   // Count all namepsace seen in current example
+  std::array<bool, NUM_NAMESPACES> is_new_ns{};
   bool new_ns_seen = false;
   for (const example* ex : ecs)
   {
     for (const auto& ns : ex->indices)
     {
       if (std::find(NS_EXCLUDE_LIST.begin(), NS_EXCLUDE_LIST.end(), ns) != NS_EXCLUDE_LIST.end()) { continue; }
-      ns_counter[ns]++;
-      if (ns_counter[ns] == 1) { new_ns_seen = true; }
+      if (++ns_counter[ns] == 1)
+      {
+        is_new_ns[ns] = true;
+        new_ns_seen = true;
+      }
     }
   }
 
-  // Regenerate interactions if new namespaces are seen
   if (new_ns_seen)
   {
-    for (uint64_t live_slot = 0; live_slot < scores.size(); ++live_slot) { gen_quadratic_interactions(live_slot); }
+    for (uint64_t live_slot = 0; live_slot < scores.size(); ++live_slot)
+    { add_quadratic_interactions(live_slot, is_new_ns); }
   }
 }
 
 // Helper function to insert new configs from oracle into map of configs as well as index_queue.
-// Handles creating new config with exclusions or overwriting stale configs to avoid reallocation.
-void interaction_config_manager::insert_config(std::map<namespace_index, std::set<namespace_index>>&& new_exclusions)
+// Each new config is the champ's exclusions with (ns1, ns2) either added or removed. It is written
+// directly into the map of configs, overwriting stale configs to avoid reallocation.
+void interaction_config_manager::insert_config(
+    const std::map<namespace_index, std::set<namespace_index>>& champ_exclusions, namespace_index ns1,
+    namespace_index ns2, bool add_exclusion)
 {
   // Note that configs are never actually cleared, but valid_config_size is set to 0 instead to denote that
   // configs have become stale. Here we try to write over stale configs with new configs, and if no stale
   // configs exist we'll generate a new one.
   if (valid_config_size < configs.size())
   {
-    configs[valid_config_size].exclusions = std::move(new_exclusions);
     configs[valid_config_size].lease = global_lease;
     configs[valid_config_size].ips = 0;
     configs[valid_config_size].lower_bound = std::numeric_limits<float>::infinity();
@@ -239,7 +286,14 @@ void interaction_config_manager::insert_config(std::map<namespace_index, std::se
   else
   {
     configs[valid_config_size] = exclusion_config(global_lease);
-    configs[valid_config_size].exclusions = std::move(new_exclusions);
+  }
+  // Assigning over a stale config's exclusions reuses its map nodes.
+  auto& exclusions = configs[valid_config_size].exclusions;
+  exclusions = champ_exclusions;
+  if (add_exclusion) { exclusions[ns1].insert(ns2); }
+  else
+  {
+    exclusions[ns1].erase(ns2);
   }
   float priority = (*calc_priority)(configs[valid_config_size], ns_counter);
   index_queue.push(std::make_pair(priority, valid_config_size));
@@ -261,10 +315,7 @@ void interaction_config_manager::config_oracle()
       uint64_t rand_ind = static_cast<uint64_t>(random_state->get_and_update_random() * champ_interactions.size());
       namespace_index ns1 = champ_interactions[rand_ind][0];
       namespace_index ns2 = champ_interactions[rand_ind][1];
-      std::map<namespace_index, std::set<namespace_index>> new_exclusions(
-          configs[scores[current_champ].config_index].exclusions);
-      new_exclusions[ns1].insert(ns2);
-      insert_config(std::move(new_exclusions));
+      insert_config(configs[scores[current_champ].config_index].exclusions, ns1, ns2, true);
     }
   }
   /*
@@ -283,22 +334,14 @@ void interaction_config_manager::config_oracle()
     {
       namespace_index ns1 = interaction[0];
       namespace_index ns2 = interaction[1];
-      std::map<namespace_index, std::set<namespace_index>> new_exclusions(
-          configs[scores[current_champ].config_index].exclusions);
-      new_exclusions[ns1].insert(ns2);
-      insert_config(std::move(new_exclusions));
+      insert_config(configs[scores[current_champ].config_index].exclusions, ns1, ns2, true);
     }
     // Remove one exclusion (for each exclusion)
     for (auto& ns_pair : configs[scores[current_champ].config_index].exclusions)
     {
       namespace_index ns1 = ns_pair.first;
       for (namespace_index ns2 : ns_pair.second)
-      {
-        std::map<namespace_index, std::set<namespace_index>> new_exclusions(
-            configs[scores[current_champ].config_index].exclusions);
-        new_exclusions[ns1].erase(ns2);
-        insert_config(std::move(new_exclusions));
-      }
+      { insert_config(configs[scores[current_champ].config_index].exclusions, ns1, ns2, false); }
     }
   }
   else
@@ -543,6 +586,10 @@ void interaction_config_manager::revert_config(example* ec) { ec->interactions =
 
 
 // inner loop of learn driven by # MAX_CONFIGS
+// The live configs are learned one after the other on purpose. They only share the weights through disjoint offsets,
+// but the reductions below keep their scratch space in their own data and gd updates the normalization, contraction
+// and t in shared_data on every call. Learning them concurrently would need a copy of that state per config and
+// would no longer match the results of the sequential loop.
 template <typename CMType>
 void automl<CMType>::offset_learn(multi_learner& base, multi_ex& ec, CB::cb_class& logged, uint64_t labelled_action)
 {
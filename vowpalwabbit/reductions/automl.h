@@ -5,6 +5,7 @@
 
 #include "action_score.h"
 #include "array_parameters_dense.h"
+#include "constant.h"
 #include "distributionally_robust.h"
 #include "learner.h"
 #include "metric_sink.h"
@@ -15,6 +16,7 @@
 
 #include <fmt/format.h>
 
+#include <array>
 #include <map>
 #include <memory>
 #include <queue>
@@ -142,7 +144,12 @@ private:
   uint64_t choose();
   bool repopulate_index_queue();
   bool swap_eligible_to_inactivate(uint64_t);
-  void insert_config(std::map<namespace_index, std::set<namespace_index>>&&);
+  void insert_config(
+      const std::map<namespace_index, std::set<namespace_index>>&, namespace_index, namespace_index, bool);
+  void add_quadratic_interactions(uint64_t, const std::array<bool, NUM_NAMESPACES>&);
+
+  // Scratch space for the interactions of newly seen namespaces.
+  interaction_vec_t new_interactions;
 };
 
 template <typename CMType>
@@ -124,6 +124,7 @@ private:
 public:
   void learn(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq);
   void predict(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq);
+  void multipredict(VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq, size_t count, VW::polyprediction* pred);
   bool update_statistics(const VW::example& ec, const VW::multi_ex& ec_seq);
 
   cb_adf(shared_data* sd, VW::cb_type_t cb_type, VW::version_struct* model_file_ver, bool rank_all, float clip_p,
@@ -350,6 +351,14 @@ void cb_adf::predict(multi_learner& base, VW::multi_ex& ec_seq)
   cs_ldf_learn_or_predict<false>(base, ec_seq, _cb_labels, _cs_labels, _prepped_cs_labels, false, _offset);
 }
 
+void cb_adf::multipredict(multi_learner& base, VW::multi_ex& ec_seq, size_t count, VW::polyprediction* pred)
+{
+  _offset = ec_seq[0]->ft_offset;
+  _gen_cs.known_cost = CB_ADF::get_observed_cost_or_default_cb_adf(ec_seq);
+  gen_cs_test_example(ec_seq, _cs_labels);
+  cs_ldf_multipredict(base, ec_seq, _cb_labels, _cs_labels, _prepped_cs_labels, _offset, 0, count, pred);
+}
+
 // how to
 
 bool cb_adf::update_statistics(const VW::example& ec, const VW::multi_ex& ec_seq)
@@ -484,6 +493,12 @@ void learn(cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq) { c.learn(base,
 
 void predict(cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq) { c.predict(base, ec_seq); }
 
+void multipredict(
+    cb_adf& c, multi_learner& base, VW::multi_ex& ec_seq, size_t count, size_t, VW::polyprediction* pred, bool)
+{
+  c.multipredict(base, ec_seq, count, pred);
+}
+
 }  // namespace
 VW::LEARNER::base_learner* VW::reductions::cb_adf_setup(VW::setup_base_i& stack_builder)
 {
@@ -574,6 +589,8 @@ VW::LEARNER::base_learner* VW::reductions::cb_adf_setup(VW::setup_base_i& stack_
                 .set_output_prediction_type(VW::prediction_type_t::action_scores)
                 .set_learn_returns_prediction(lrp)
                 .set_params_per_weight(problem_multiplier)
+                // multipredict forwards to the same offsets of the base, which only line up without dr's extra slot.
+                .set_multipredict(problem_multiplier == 1 ? multipredict : nullptr)
                 .set_finish_example(::finish_multiline_example)
                 .set_print_example(::update_and_output)
                 .set_save_load(::save_load)
@@ -0,0 +1,408 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "cb_candidates.h"
+
+#include "../gd.h"
+#include "cb.h"
+#include "example.h"
+#include "global_data.h"
+#include "interactions.h"
+#include "label_dictionary.h"
+#include "learner.h"
+#include "parser.h"
+#include "setup_base.h"
+#include "text_utils.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/options.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace VW::LEARNER;
+using namespace VW::config;
+
+/*
+Picks a shortlist of candidate actions for the contextual bandit reductions below, so that only those are scored and
+explored over. When probabilities are predicted, --cb_candidates_explore of the probability mass is spread
+uniformly over all the actions, so that the ones left out of the shortlist are still explored, get labels, and can
+make it into later shortlists. When action scores are predicted, the actions left out get a cost of FLT_MAX.
+
+The candidates are the actions with the smallest approximate cost under the current weights. This is not a retrieval
+index: every action of the multi_ex is still parsed, hashed and given an approximate cost, so a request stays linear in
+the number of actions. What is saved is the work of the reductions below, such as multiple policies, exploration and
+learning, which only see the shortlist.
+
+With low rank quadratics (--lrq), the part of a prediction which varies across actions is exactly
+
+  cost(a) = lin(a) + int(a) + lrq(a, a) + <q(shared), e(a)>
+
+where lin(a) is the linear score of the action's features, int(a) the score of the -q/--interactions terms of the
+action merged with the shared example, and q and e stack, for every --lrq pair and every rank, the weighted sums of
+the shared and the action features of each side of the pair. The embeddings e(a), and the bias lin(a) + lrq(a, a),
+are cached per distinct action (by the hash of its features). int(a) depends on the shared features, so it cannot be
+cached, and is computed in full like gd would: only without interactions, or with --lrq in their place, is the
+approximate cost much cheaper than scoring an action. Interactions with wildcards are only expanded below and are left out.
+
+Cached embeddings are recomputed after the action is the labeled one of a learned example, and otherwise after
+--cb_candidates_refresh learned examples, since the weights of features shared with other actions change too. Every
+--cb_candidates_refresh multi_ex, the embeddings which are stale or were not used since the last sweep are dropped, so
+the cache only holds the actions seen recently.
+*/
+
+namespace
+{
+struct lrq_pair
+{
+  VW::namespace_index left;
+  VW::namespace_index right;
+  uint32_t rank;
+};
+
+struct action_embedding
+{
+  float bias = 0.f;
+  std::vector<float> values;
+  uint64_t learn_count = 0;   // number of examples learned when it was computed
+  uint64_t last_request = 0;  // multi_ex it was last used for
+};
+
+struct cb_candidates
+{
+  VW::workspace* all = nullptr;
+  size_t num_candidates = 0;
+  uint64_t refresh_interval = 0;
+  VW::label_type_t label_type = VW::label_type_t::cb;
+  float fill_value = 0.f;  // prediction of the actions which are not candidates, before exploration
+  float explore = 0.f;     // probability mass spread uniformly over all actions
+  bool has_interactions = false;
+
+  std::vector<lrq_pair> pairs;
+  float lrq_scale = 1.f;
+  size_t num_dims = 0;
+
+  uint64_t learn_count = 0;
+  uint64_t request_count = 0;
+  std::unordered_map<uint64_t, action_embedding> embeddings;
+
+  // Scratch space reused from one multi_ex to the next.
+  std::vector<float> query;
+  std::vector<uint64_t> keys;
+  std::vector<std::pair<float, uint32_t>> approx_costs;
+  std::vector<uint32_t> selected;
+  VW::multi_ex actions;
+  VW::multi_ex candidates;
+};
+
+uint64_t action_key(const VW::example& ec)
+{
+  uint64_t key = 14695981039346656037ULL ^ ec.ft_offset;
+  auto mix = [&key](uint64_t word) { key = (key ^ word) * 1099511628211ULL; };
+  for (auto ns : ec.indices)
+  {
+    mix(ns);
+    const auto& fs = ec.feature_space[ns];
+    for (size_t i = 0; i < fs.size(); ++i)
+    {
+      uint32_t value_bits;
+      std::memcpy(&value_bits, &fs.values[i], sizeof(value_bits));
+      mix(fs.indices[i]);
+      mix(value_bits);
+    }
+  }
+  return key;
+}
+
+// out[n - 1] += sum of x * w[i + n], n = 1..rank, over the features of ns. This is one side of an --lrq pair.
+void add_lrq_side(VW::workspace& all, const VW::example& ec, VW::namespace_index ns, uint32_t rank, float* out)
+{
+  const auto& fs = ec.feature_space[ns];
+  const uint32_t stride_shift = all.weights.stride_shift();
+  for (size_t i = 0; i < fs.size(); ++i)
+  {
+    const uint64_t index = fs.indices[i] + ec.ft_offset;
+    for (uint32_t n = 1; n <= rank; ++n)
+    { out[n - 1] += fs.values[i] * all.weights[index + (static_cast<uint64_t>(n) << stride_shift)]; }
+  }
+}
+
+void compute_embedding(cb_candidates& data, const VW::example& action, action_embedding& embedding)
+{
+  VW::workspace& all = *data.all;
+  embedding.bias = 0.f;
+  // With interactions, the linear terms are scored along with them on the merged example.
+  for (auto ns : action.indices)
+  {
+    if (data.has_interactions) { break; }
+    if (all.ignore_some_linear && all.ignore_linear[ns]) { continue; }
+    const auto& fs = action.feature_space[ns];
+    for (size_t i = 0; i < fs.size(); ++i)
+    { embedding.bias += fs.values[i] * all.weights[fs.indices[i] + action.ft_offset]; }
+  }
+
+  // Each pair's block holds the right side sums, then the left side sums, to line up with the query's left then right.
+  embedding.values.assign(data.num_dims, 0.f);
+  float* block = embedding.values.data();
+  for (const auto& pair : data.pairs)
+  {
+    add_lrq_side(all, action, pair.right, pair.rank, block);
+    add_lrq_side(all, action, pair.left, pair.rank, block + pair.rank);
+    for (uint32_t n = 0; n < pair.rank; ++n) { embedding.bias += data.lrq_scale * block[n] * block[pair.rank + n]; }
+    block += 2 * pair.rank;
+  }
+  embedding.learn_count = data.learn_count;
+}
+
+void compute_query(cb_candidates& data, const VW::example* shared)
+{
+  data.query.assign(data.num_dims, 0.f);
+  if (shared == nullptr) { return; }
+  float* block = data.query.data();
+  for (const auto& pair : data.pairs)
+  {
+    add_lrq_side(*data.all, *shared, pair.left, pair.rank, block);
+    add_lrq_side(*data.all, *shared, pair.right, pair.rank, block + pair.rank);
+    for (uint32_t n = 0; n < 2 * pair.rank; ++n) { block[n] *= data.lrq_scale; }
+    block += 2 * pair.rank;
+  }
+}
+
+// The linear and interaction terms of the action with the shared features merged in, as gd scores them below the
+// shared feature merger.
+float merged_score(cb_candidates& data, VW::example& action, VW::example* shared)
+{
+  if (shared != nullptr) { LabelDict::add_example_namespaces_from_example(action, *shared); }
+  const float score = GD::inline_predict(*data.all, action);
+  if (shared != nullptr) { LabelDict::del_example_namespaces_from_example(action, *shared); }
+  return score;
+}
+
+float approximate_cost(cb_candidates& data, VW::example& action, VW::example* shared, uint64_t key)
+{
+  auto inserted = data.embeddings.emplace(key, action_embedding{});
+  auto& embedding = inserted.first->second;
+  if (inserted.second || data.learn_count - embedding.learn_count >= data.refresh_interval)
+  { compute_embedding(data, action, embedding); }
+  embedding.last_request = data.request_count;
+
+  float cost = embedding.bias;
+  if (data.has_interactions) { cost += merged_score(data, action, shared); }
+  for (size_t i = 0; i < data.num_dims; ++i) { cost += data.query[i] * embedding.values[i]; }
+  return cost;
+}
+
+// Drops the embeddings that would be recomputed anyway or were not used during the last refresh interval.
+void sweep_embeddings(cb_candidates& data)
+{
+  for (auto it = data.embeddings.begin(); it != data.embeddings.end();)
+  {
+    const auto& embedding = it->second;
+    if (data.learn_count - embedding.learn_count >= data.refresh_interval ||
+        data.request_count - embedding.last_request >= data.refresh_interval)
+    { it = data.embeddings.erase(it); }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+// Selects the candidate actions, in their original order. While learning, the actions with an observed cost are
+// always candidates.
+template <bool is_learn>
+void select_candidates(cb_candidates& data, VW::multi_ex& actions, VW::example* shared)
+{
+  compute_query(data, shared);
+  data.approx_costs.clear();
+  for (uint32_t i = 0; i < actions.size(); ++i)
+  { data.approx_costs.emplace_back(approximate_cost(data, *actions[i], shared, data.keys[i]), i); }
+
+  std::nth_element(
+      data.approx_costs.begin(), data.approx_costs.begin() + data.num_candidates, data.approx_costs.end());
+  data.selected.clear();
+  for (size_t i = 0; i < data.num_candidates; ++i) { data.selected.push_back(data.approx_costs[i].second); }
+  if (is_learn)
+  {
+    for (size_t i = data.num_candidates; i < data.approx_costs.size(); ++i)
+    {
+      const uint32_t action = data.approx_costs[i].second;
+      if (CB::get_observed_cost_cb(actions[action]->l.cb).first) { data.selected.push_back(action); }
+    }
+  }
+  std::sort(data.selected.begin(), data.selected.end());
+}
+
+// Maps the prediction on the candidates back to the indices of all the actions, appending the others. The
+// exploration mass is mixed in afterwards, which keeps the candidates ahead of the others and in the same order.
+void expand_prediction(cb_candidates& data, ACTION_SCORE::action_scores& a_s, size_t num_actions)
+{
+  for (auto& as : a_s) { as.action = data.selected[as.action]; }
+  size_t next_selected = 0;
+  for (uint32_t i = 0; i < num_actions; ++i)
+  {
+    if (next_selected < data.selected.size() && data.selected[next_selected] == i) { ++next_selected; }
+    else
+    {
+      a_s.push_back({i, data.fill_value});
+    }
+  }
+
+  if (data.explore > 0.f)
+  {
+    const float uniform = data.explore / static_cast<float>(num_actions);
+    for (auto& as : a_s) { as.score = (1.f - data.explore) * as.score + uniform; }
+  }
+}
+
+template <bool is_learn>
+void predict_or_learn(cb_candidates& data, multi_learner& base, VW::multi_ex& examples)
+{
+  const bool has_header = !examples.empty() && ec_is_example_header(*examples[0], data.label_type);
+  VW::example* shared = has_header ? examples[0] : nullptr;
+  auto& actions = data.actions;
+  actions.assign(examples.begin() + (has_header ? 1 : 0), examples.end());
+
+  if (actions.size() <= data.num_candidates)
+  {
+    if (is_learn) { base.learn(examples); }
+    else
+    {
+      base.predict(examples);
+    }
+  }
+  else
+  {
+    data.keys.clear();
+    for (const auto* action : actions) { data.keys.push_back(action_key(*action)); }
+    select_candidates<is_learn>(data, actions, shared);
+    data.candidates.clear();
+    if (has_header) { data.candidates.push_back(shared); }
+    for (auto i : data.selected) { data.candidates.push_back(actions[i]); }
+
+    if (is_learn) { base.learn(data.candidates); }
+    else
+    {
+      base.predict(data.candidates);
+    }
+
+    if (!is_learn || base.learn_returns_prediction)
+    {
+      if (data.candidates[0] != examples[0]) { std::swap(data.candidates[0]->pred.a_s, examples[0]->pred.a_s); }
+      expand_prediction(data, examples[0]->pred.a_s, actions.size());
+    }
+  }
+
+  if (is_learn)
+  {
+    ++data.learn_count;
+    // The labeled action's features were updated, so its embedding is recomputed the next time it is needed.
+    for (const auto* action : actions)
+    {
+      if (CB::get_observed_cost_cb(action->l.cb).first) { data.embeddings.erase(action_key(*action)); }
+    }
+  }
+  if (++data.request_count % data.refresh_interval == 0) { sweep_embeddings(data); }
+}
+}  // namespace
+
+base_learner* VW::reductions::cb_candidates_setup(VW::setup_base_i& stack_builder)
+{
+  options_i& options = *stack_builder.get_options();
+  VW::workspace& all = *stack_builder.get_all_pointer();
+  auto data = VW::make_unique<cb_candidates>();
+  uint64_t num_candidates = 0;
+  uint64_t refresh_interval = 0;
+  float explore = 0.f;
+
+  option_group_definition new_options("[Reduction] Contextual Bandit Candidate Actions");
+  new_options
+      .add(make_option("cb_candidates", num_candidates)
+               .keep()
+               .necessary()
+               .help("Score and explore over only this many actions, the ones with the smallest approximate cost. "
+                     "Every action still gets an approximate cost, from cached embeddings of its learned linear and "
+                     "--lrq weights, so this saves the work of the reductions below rather than making requests "
+                     "sublinear in the number of actions"))
+      .add(make_option("cb_candidates_refresh", refresh_interval)
+               .default_value(100)
+               .help("Recompute a cached action embedding after this many learned examples"))
+      .add(make_option("cb_candidates_explore", explore)
+               .default_value(0.05f)
+               .help("Probability mass spread uniformly over all the actions, so that the ones left out of the "
+                     "shortlist are still explored"));
+
+  if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
+  if (num_candidates == 0) { THROW("--cb_candidates must be at least 1"); }
+  if (refresh_interval == 0) { THROW("--cb_candidates_refresh must be at least 1"); }
+  if (explore < 0.f || explore > 1.f) { THROW("--cb_candidates_explore must be in [0, 1]"); }
+
+  auto* base = stack_builder.setup_base_learner();
+  if (base == nullptr || !base->is_multiline() || base->get_input_label_type() != VW::label_type_t::cb)
+  {
+    THROW("--cb_candidates requires a contextual bandit reduction with action dependent features, such as "
+          "--cb_explore_adf");
+  }
+
+  if (base->get_output_prediction_type() == VW::prediction_type_t::action_probs)
+  {
+    data->fill_value = 0.f;
+    data->explore = explore;
+  }
+  else if (base->get_output_prediction_type() == VW::prediction_type_t::action_scores)
+  {
+    data->fill_value = FLT_MAX;
+  }
+  else
+  {
+    THROW("--cb_candidates requires action scores or probabilities to be predicted");
+  }
+
+  if (options.was_supplied("lrq"))
+  {
+    for (const auto& name : options.get_typed_option<std::vector<std::string>>("lrq").value())
+    {
+      const std::string pair = VW::decode_inline_hex(name, all.logger);
+      if (pair.size() < 3) { continue; }
+      const uint32_t rank = static_cast<uint32_t>(std::atoi(pair.c_str() + 2));
+      data->pairs.push_back(
+          {static_cast<VW::namespace_index>(pair[0]), static_cast<VW::namespace_index>(pair[1]), rank});
+      data->num_dims += 2 * rank;
+    }
+    // --lrqdropout halves the low rank terms when predicting.
+    if (options.was_supplied("lrqdropout")) { data->lrq_scale = 0.5f; }
+  }
+
+  data->has_interactions = !all.interactions.empty() || !all.extent_interactions.empty();
+  if (data->has_interactions && data->pairs.empty())
+  {
+    all.logger.err_warn(
+        "--cb_candidates scores the -q/--interactions terms of every action in full, which costs about as much as "
+        "scoring all the actions. Use --lrq for the pairs of shared and action namespaces to make the shortlist "
+        "cheaper.");
+  }
+  const bool has_wildcards =
+      std::any_of(all.interactions.begin(), all.interactions.end(),
+          [](const std::vector<VW::namespace_index>& i) { return INTERACTIONS::contains_wildcard(i); }) ||
+      std::any_of(all.extent_interactions.begin(), all.extent_interactions.end(),
+          [](const std::vector<extent_term>& i) { return INTERACTIONS::contains_wildcard(i); });
+  if (has_wildcards)
+  { all.logger.err_warn("--cb_candidates leaves interactions with wildcards out of the approximate cost of actions"); }
+
+  data->all = &all;
+  data->num_candidates = num_candidates;
+  data->refresh_interval = refresh_interval;
+  data->label_type = all.example_parser->lbl_parser.label_type;
+
+  auto* learner = make_reduction_learner(std::move(data), as_multiline(base), predict_or_learn<true>,
+      predict_or_learn<false>, stack_builder.get_setupfn_name(cb_candidates_setup))
+                      .set_learn_returns_prediction(base->learn_returns_prediction)
+                      .build();
+  return make_base(*learner);
+}
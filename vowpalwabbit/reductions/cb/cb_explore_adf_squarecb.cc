@@ -127,20 +127,24 @@ float cb_explore_adf_squarecb::binary_search(float fhat, float delta, float sens
 }
 
 // TODO: Same as cb_explore_adf_regcb.cc
+// Computes the range of plausible costs of every action. With min_only only the min costs are computed, as the
+// optimistic variant needs. Otherwise the ranges are used for elimination, where an action survives when its min cost
+// is at most the smallest max cost. The max costs are computed first, so the min cost of an action predicted at most
+// that smallest max cost is left at its prediction: its bound can only be lower and it survives either way, without
+// a sensitivity computation. Sensitivities are also skipped for bounds clamped to the cost range.
 void cb_explore_adf_squarecb::get_cost_ranges(float delta, multi_learner& base, multi_ex& examples, bool min_only)
 {
   const size_t num_actions = examples[0]->pred.a_s.size();
   _min_costs.resize(num_actions);
   _max_costs.resize(num_actions);
 
-  _ex_as.clear();
-  _ex_costs.clear();
-
-  // backup cb example data
-  for (const auto& ex : examples)
+  // backup cb example data, reusing the storage of previous calls
+  _ex_as.resize(examples.size());
+  _ex_costs.resize(examples.size());
+  for (size_t i = 0; i < examples.size(); ++i)
   {
-    _ex_as.push_back(ex->pred.a_s);
-    _ex_costs.push_back(ex->l.cb.costs);
+    _ex_as[i] = examples[i]->pred.a_s;
+    _ex_costs[i] = examples[i]->l.cb.costs;
   }
 
   // set regressor predictions
@@ -149,32 +153,46 @@ void cb_explore_adf_squarecb::get_cost_ranges(float delta, multi_learner& base,
   const float cmin = _min_cb_cost;
   const float cmax = _max_cb_cost;
 
+  float min_max_cost = FLT_MAX;
+  if (!min_only)
+  {
+    for (size_t a = 0; a < num_actions; ++a)
+    {
+      example* ec = examples[a];
+      _max_costs[a] = cmax;
+      if (ec->pred.scalar <= cmax)
+      {
+        ec->l.simple.label = cmax + 1;
+        const float sens = base.sensitivity(*ec);
+        if (!std::isnan(sens) && !std::isinf(sens))
+        {
+          const float w = binary_search(cmax + 1 - ec->pred.scalar, delta, sens);
+          _max_costs[a] = (std::min)(ec->pred.scalar + sens * w, cmax);
+          if (_max_costs[a] < cmin) { _max_costs[a] = cmin; }
+        }
+      }
+      min_max_cost = (std::min)(min_max_cost, _max_costs[a]);
+    }
+  }
+
   for (size_t a = 0; a < num_actions; ++a)
   {
     example* ec = examples[a];
-    ec->l.simple.label = cmin - 1;
-    float sens = base.sensitivity(*ec);
-    float w = 0;  // importance weight
-
-    if (ec->pred.scalar < cmin || std::isnan(sens) || std::isinf(sens)) { _min_costs[a] = cmin; }
-    else
+    _min_costs[a] = cmin;
+    if (ec->pred.scalar < cmin) { continue; }
+    if (!min_only && ec->pred.scalar <= min_max_cost)
     {
-      w = binary_search(ec->pred.scalar - cmin + 1, delta, sens);
-      _min_costs[a] = (std::max)(ec->pred.scalar - sens * w, cmin);
-      if (_min_costs[a] > cmax) { _min_costs[a] = cmax; }
+      _min_costs[a] = (std::min)(ec->pred.scalar, cmax);
+      continue;
     }
 
-    if (!min_only)
+    ec->l.simple.label = cmin - 1;
+    const float sens = base.sensitivity(*ec);
+    if (!std::isnan(sens) && !std::isinf(sens))
     {
-      ec->l.simple.label = cmax + 1;
-      sens = base.sensitivity(*ec);
-      if (ec->pred.scalar > cmax || std::isnan(sens) || std::isinf(sens)) { _max_costs[a] = cmax; }
-      else
-      {
-        w = binary_search(cmax + 1 - ec->pred.scalar, delta, sens);
-        _max_costs[a] = (std::min)(ec->pred.scalar + sens * w, cmax);
-        if (_max_costs[a] < cmin) { _max_costs[a] = cmin; }
-      }
+      const float w = binary_search(ec->pred.scalar - cmin + 1, delta, sens);
+      _min_costs[a] = (std::max)(ec->pred.scalar - sens * w, cmin);
+      if (_min_costs[a] > cmax) { _min_costs[a] = cmax; }
     }
   }
 
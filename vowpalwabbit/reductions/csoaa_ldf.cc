@@ -43,10 +43,12 @@ struct ldf
   VW::workspace* all = nullptr;
 
   bool rank = false;
+  uint64_t rank_top_k = 0;  // only the best rank_top_k actions are ordered, 0 orders them all
   action_scores a_s;
   uint64_t ft_offset = 0;
 
   std::vector<action_scores> stored_preds;
+  std::vector<VW::polyprediction> member_preds;  // one per policy scored by multipredict_csoaa_ldf_rank
 };
 
 inline bool cmp_wclass_ptr(const COST_SENSITIVE::wclass* a, const COST_SENSITIVE::wclass* b) { return a->x < b->x; }
@@ -125,6 +127,40 @@ void make_single_prediction(ldf& data, single_learner& base, VW::example& ec)
   base.predict(ec);  // make a prediction
 }
 
+// Ranks an action which the workspace's action_candidate_filter rejected last without scoring it.
+void prune_action(VW::example& ec)
+{
+  ec.partial_prediction = FLT_MAX;
+  // WARNING: Access of label information when making prediction is
+  // problematic.
+  ec.l.cs.costs[0].partial_prediction = FLT_MAX;
+}
+
+// Like make_single_prediction, but scores `count` consecutive policies with one pass over the features of ec.
+void make_single_multiprediction(ldf& data, single_learner& base, VW::example& ec, size_t count)
+{
+  uint64_t old_offset = ec.ft_offset;
+
+  LabelDict::add_example_namespace_from_memory(data.label_features, ec, ec.l.cs.costs[0].class_index);
+
+  auto restore_guard = VW::scope_exit([&data, old_offset, &ec] {
+    ec.ft_offset = old_offset;
+    ec.partial_prediction = data.member_preds[0].scalar;
+    // WARNING: Access of label information when making prediction is
+    // problematic.
+    ec.l.cs.costs[0].partial_prediction = ec.partial_prediction;
+    // WARNING: Access of label information when making prediction is
+    // problematic.
+    LabelDict::del_example_namespace_from_memory(data.label_features, ec, ec.l.cs.costs[0].class_index);
+  });
+
+  ec.l.simple = label_data{FLT_MAX};
+  ec._reduction_features.template get<simple_label_reduction_features>().reset_to_default();
+
+  ec.ft_offset = data.ft_offset;
+  base.multipredict(ec, 0, count, data.member_preds.data(), false);
+}
+
 bool test_ldf_sequence(ldf& /*data*/, const VW::multi_ex& ec_seq, VW::io::logger& logger)
 {
   bool isTest;
@@ -389,7 +425,7 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_se
   data.stored_preds.clear();
 
   auto restore_guard = VW::scope_exit([&data, &ec_seq_all, K] {
-    std::sort(data.a_s.begin(), data.a_s.end(), VW::action_score_compare_lt);
+    VW::sort_top_k(data.a_s, data.rank_top_k);
 
     data.stored_preds[0].clear();
     for (size_t k = 0; k < K; k++)
@@ -402,10 +438,17 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_se
     if (data.is_probabilities) { convert_to_probabilities(ec_seq_all); }
   });
 
+  const auto& candidate_filter = data.all->action_candidate_filter;
   for (uint32_t k = 0; k < K; k++)
   {
     VW::example* ec = ec_seq_all[k];
     data.stored_preds.emplace_back(std::move(ec->pred.a_s));
+    if (candidate_filter && !candidate_filter(ec_seq_all, k))
+    {
+      prune_action(*ec);
+      data.a_s.push_back({ec->l.cs.costs[0].class_index, FLT_MAX});
+      continue;
+    }
     make_single_prediction(data, base, *ec);
     action_score s;
     s.score = ec->partial_prediction;
@@ -414,6 +457,36 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_se
   }
 }
 
+// Ranks the actions for `count` consecutive policies, as predict_csoaa_ldf_rank would for each of them, while walking
+// the features and interactions of every action only once. Only used with the identity link, so that the unfinalized
+// scores of the base are the partial predictions the single policy path ranks by.
+void multipredict_csoaa_ldf_rank(ldf& data, single_learner& base, VW::multi_ex& ec_seq_all, size_t count,
+    size_t /*step*/, VW::polyprediction* pred, bool /*finalize_predictions*/)
+{
+  if (ec_seq_all.empty()) { return; }
+  data.ft_offset = ec_seq_all[0]->ft_offset;
+
+  for (size_t c = 0; c < count; c++) { pred[c].a_s.clear(); }
+  data.member_preds.resize(count);
+
+  const auto& candidate_filter = data.all->action_candidate_filter;
+  for (size_t k = 0; k < ec_seq_all.size(); k++)
+  {
+    VW::example* ec = ec_seq_all[k];
+    const uint32_t action = ec->l.cs.costs[0].class_index;
+    if (candidate_filter && !candidate_filter(ec_seq_all, k))
+    {
+      prune_action(*ec);
+      for (size_t c = 0; c < count; c++) { pred[c].a_s.push_back({action, FLT_MAX}); }
+      continue;
+    }
+    make_single_multiprediction(data, base, *ec, count);
+    for (size_t c = 0; c < count; c++) { pred[c].a_s.push_back({action, data.member_preds[c].scalar}); }
+  }
+
+  for (size_t c = 0; c < count; c++) { VW::sort_top_k(pred[c].a_s, data.rank_top_k); }
+}
+
 void output_example(
     VW::workspace& all, const VW::example& ec, bool& hit_loss, const VW::multi_ex* ec_seq, const ldf& data)
 {
@@ -634,6 +707,10 @@ base_learner* VW::reductions::csldf_setup(VW::setup_base_i& stack_builder)
       .add(make_option("ldf_override", ldf_override)
                .help("Override singleline or multiline from csoaa_ldf or wap_ldf, eg if stored in file"))
       .add(make_option("csoaa_rank", ld->rank).keep().help("Return actions sorted by score order"))
+      .add(make_option("rank_top_k", ld->rank_top_k)
+               .default_value(0)
+               .help("With --csoaa_rank, only sort the k best actions to the front, in O(n log k). The remaining "
+                     "actions follow in unspecified order. 0 sorts all actions"))
       .add(make_option("probabilities", ld->is_probabilities).keep().help("Predict probabilities of all classes"));
 
   option_group_definition csldf_inner_options(
@@ -724,7 +801,14 @@ base_learner* VW::reductions::csldf_setup(VW::setup_base_i& stack_builder)
     pred_ptr = predict_csoaa_ldf;
   }
 
+  // The scorer applies its link to multipredict results even when they are not finalized.
+  const bool identity_link =
+      !options.was_supplied("link") || options.get_typed_option<std::string>("link").value() == "identity";
+  void (*multipred_ptr)(ldf&, single_learner&, VW::multi_ex&, size_t, size_t, VW::polyprediction*, bool) =
+      (ld->rank && !ld->is_probabilities && identity_link) ? multipredict_csoaa_ldf_rank : nullptr;
+
   auto* l = make_reduction_learner(std::move(ld), pbase, learn_csoaa_ldf, pred_ptr, name + name_addition)
+                .set_multipredict(multipred_ptr)
                 .set_finish_example(finish_multiline_example)
                 .set_end_pass(end_pass)
                 .set_input_label_type(VW::label_type_t::cs)
@@ -0,0 +1,60 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "reductions/fused_stacks.h"
+
+#include "learner.h"
+#include "reductions/gd.h"
+#include "setup_base.h"
+#include "vw/config/options.h"
+
+using namespace VW::config;
+using namespace VW::LEARNER;
+
+namespace VW
+{
+namespace reductions
+{
+struct stack_fuser
+{
+  static bool fuse_scorer(base_learner& scorer, const std::string& link)
+  {
+    base_learner* base = scorer.learn_fd.base;
+    if (base == nullptr || base->get_name() != "gd") { return false; }
+
+    // The scorer keeps its base, which the fused functions are called with.
+    LEARNER::details::learn_data fused = scorer.learn_fd;
+    if (!GD::get_fused_scorer(*static_cast<GD::gd*>(base->learn_fd.data), link, fused)) { return false; }
+    scorer.learn_fd = fused;
+    return true;
+  }
+};
+}  // namespace reductions
+}  // namespace VW
+
+VW::LEARNER::base_learner* VW::reductions::fused_stacks_setup(VW::setup_base_i& stack_builder)
+{
+  options_i& options = *stack_builder.get_options();
+  bool no_fused_stacks = false;
+  option_group_definition new_options("[Reduction] Fused Stacks");
+  new_options.add(make_option("no_fused_stacks", no_fused_stacks)
+                      .help("Call every reduction through the learner function pointers, instead of fusing the "
+                            "reductions of common stacks with their base"));
+  options.add_and_parse(new_options);
+
+  // Set up right above the scorer, which is always part of the stack.
+  auto* base = stack_builder.setup_base_learner();
+
+  // When called to determine the name base will be nullptr.
+  if (base == nullptr) { return nullptr; }
+
+  // --profile_reductions times each learner, which it cannot do inside a fused call.
+  if (no_fused_stacks || options.was_supplied("profile_reductions")) { return base; }
+
+  if (base->get_name().find("scorer-") == 0)
+  { stack_fuser::fuse_scorer(*base, options.get_typed_option<std::string>("link").value()); }
+
+  // Like count_label, this is not a learner of its own: the base is returned whether it was fused or not.
+  return base;
+}
@@ -0,0 +1,20 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "vw_fwd.h"
+
+namespace VW
+{
+namespace reductions
+{
+// Fuses the reductions of common stacks with their base once they are built, unless --no_fused_stacks is given. A fused
+// reduction calls its base directly, so the call is inlined instead of going through the learner function pointers.
+//
+// The scorer is fused with gd when gd uses the default update rule, which saves a call per example and per action of
+// multiline stacks such as --cb_explore_adf. A fused stack predicts and learns exactly like the stack it replaces.
+VW::LEARNER::base_learner* fused_stacks_setup(VW::setup_base_i& stack_builder);
+}  // namespace reductions
+}  // namespace VW
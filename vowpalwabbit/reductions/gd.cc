@@ -8,7 +8,15 @@
 #include "loss_functions.h"
 #include "setup_base.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #if !defined(VW_NO_INLINE_SIMD)
 #  if !defined(__SSE2__) && (defined(_M_AMD64) || defined(_M_X64))
@@ -27,7 +35,10 @@
 #include "gd.h"
 #include "label_parser.h"
 #include "parse_regressor.h"
+#include "reductions/scorer.h"
+#include "scope_exit.h"
 #include "shared_data.h"
+#include "shared_feature_cache.h"
 #include "vw.h"
 #include "vw_versions.h"
 
@@ -194,7 +205,7 @@ struct audit_results
 {
   VW::workspace& all;
   const uint64_t offset;
-  std::vector<VW::audit_strings> components;
+  std::vector<const VW::audit_strings*> components;  // of the feature being audited, copied for new invert_hash entries
   std::vector<string_value> results;
   audit_results(VW::workspace& p_all, const size_t p_offset) : all(p_all), offset(p_offset) {}
 };
@@ -207,7 +218,23 @@ inline void audit_interaction(audit_results& dat, const VW::audit_strings* f)
 
     return;
   }
-  if (!f->is_empty()) { dat.components.push_back(*f); }
+  if (!f->is_empty()) { dat.components.push_back(f); }
+}
+
+inline bool needs_invert_hash_entry(const VW::workspace& all, uint64_t strided_index)
+{
+  return (all.current_pass == 0 || all.training == false) && all.hash_inv &&
+      all.index_name_map.count(strided_index) == 0;
+}
+
+void add_invert_hash_entry(
+    audit_results& dat, uint64_t strided_index, std::vector<VW::audit_strings> weight_components, size_t stride_shift)
+{
+  VW::details::invert_hash_info info;
+  info.weight_components = std::move(weight_components);
+  info.offset = dat.offset;
+  info.stride_shift = stride_shift;
+  dat.all.index_name_map.insert(std::make_pair(strided_index, std::move(info)));
 }
 
 inline void audit_feature(audit_results& dat, const float ft_weight, const uint64_t ft_idx)
@@ -216,15 +243,15 @@ inline void audit_feature(audit_results& dat, const float ft_weight, const uint6
   uint64_t index = ft_idx & weights.mask();
   size_t stride_shift = weights.stride_shift();
 
-  std::ostringstream tempstream;
-  for (size_t i = 0; i < dat.components.size(); i++)
-  {
-    if (i > 0) { tempstream << "*"; }
-    tempstream << VW::to_string(dat.components[i]);
-  }
-
   if (dat.all.audit)
   {
+    std::ostringstream tempstream;
+    for (size_t i = 0; i < dat.components.size(); i++)
+    {
+      if (i > 0) { tempstream << "*"; }
+      tempstream << VW::to_string(*dat.components[i]);
+    }
+
     tempstream << ':' << (index >> stride_shift) << ':' << ft_weight << ':'
                << trunc_weight(weights[index], static_cast<float>(dat.all.sd->gravity)) *
             static_cast<float>(dat.all.sd->contraction);
@@ -238,17 +265,31 @@ inline void audit_feature(audit_results& dat, const float ft_weight, const uint6
     dat.results.push_back(sv);
   }
 
-  if ((dat.all.current_pass == 0 || dat.all.training == false) && dat.all.hash_inv)
+  const auto strided_index = index >> stride_shift;
+  if (needs_invert_hash_entry(dat.all, strided_index))
   {
-    const auto strided_index = index >> stride_shift;
-    if (dat.all.index_name_map.count(strided_index) == 0)
-    {
-      VW::details::invert_hash_info info;
-      info.weight_components = dat.components;
-      info.offset = dat.offset;
-      info.stride_shift = stride_shift;
-      dat.all.index_name_map.insert(std::make_pair(strided_index, info));
-    }
+    std::vector<VW::audit_strings> weight_components;
+    weight_components.reserve(dat.components.size());
+    for (const auto* component : dat.components) { weight_components.push_back(*component); }
+    add_invert_hash_entry(dat, strided_index, std::move(weight_components), stride_shift);
+  }
+}
+
+// Without --audit, the names of the features are only needed for the invert_hash entries of the features not seen
+// yet, so only those are built from the lazy audit strings of the parser.
+void invert_hash_features(audit_results& dat, const features& fs, uint64_t ft_offset)
+{
+  const auto& weights = dat.all.weights;
+  const size_t stride_shift = weights.stride_shift();
+  for (size_t i = 0; i < fs.size(); i++)
+  {
+    const uint64_t strided_index = ((fs.indices[i] + ft_offset) & weights.mask()) >> stride_shift;
+    if (!needs_invert_hash_entry(dat.all, strided_index)) { continue; }
+
+    std::vector<VW::audit_strings> weight_components;
+    auto strings = fs.space_names.get(i);
+    if (!strings.is_empty()) { weight_components.push_back(std::move(strings)); }
+    add_invert_hash_entry(dat, strided_index, std::move(weight_components), stride_shift);
   }
 }
 
@@ -280,7 +321,8 @@ void print_features(VW::workspace& all, VW::example& ec)
 
     for (features& fs : ec)
     {
-      if (fs.space_names.size() > 0)
+      if (fs.space_names.size() > 0 && !all.audit) { invert_hash_features(dat, fs, ec.ft_offset); }
+      else if (fs.space_names.size() > 0)
       {
         for (const auto& f : fs.audit_range())
         {
@@ -357,6 +399,91 @@ inline void vec_add_print(float& p, const float fx, float& fw)
   std::cerr << " + " << fw << "*" << fx;
 }
 
+template <bool l1>
+inline float predict_terms(VW::workspace& all, VW::example& ec, size_t& num_interacted_features)
+{
+  return l1 ? trunc_predict(all, ec, all.sd->gravity, num_interacted_features)
+            : inline_predict(all, ec, num_interacted_features);
+}
+
+// Scores the namespaces in cache.indices and the given interactions of ec, leaving ec itself unchanged.
+template <bool l1>
+float predict_subset(VW::workspace& all, VW::example& ec, VW::shared_feature_cache& cache,
+    const VW::shared_feature_cache::interactions_t& interactions, size_t& num_interacted_features)
+{
+  auto* saved_interactions = ec.interactions;
+  std::swap(ec.indices, cache.indices);
+  ec.interactions = const_cast<VW::shared_feature_cache::interactions_t*>(&interactions);
+  auto restore_guard = VW::scope_exit([&ec, &cache, saved_interactions] {
+    std::swap(ec.indices, cache.indices);
+    ec.interactions = saved_interactions;
+  });
+  return predict_terms<l1>(all, ec, num_interacted_features);
+}
+
+// Reductions below shared_feature_merger, such as lrq, lrqfa, marginal or stagewise_poly, may add features to the
+// shared namespaces merged into an action or rewrite them. The cached scores only hold for actions which still carry
+// exactly the features of the shared example.
+bool has_unchanged_shared_namespaces(const VW::example& ec, const VW::shared_feature_cache& cache)
+{
+  const VW::example& shared = *cache.shared;
+  for (auto ns : shared.indices)
+  {
+    if (!cache.is_shared_namespace[ns]) { continue; }
+    const auto& shared_fs = shared.feature_space[ns];
+    const auto& fs = ec.feature_space[ns];
+    if (fs.size() != shared_fs.size()) { return false; }
+    if (fs.empty()) { continue; }
+    if (std::memcmp(fs.values.begin(), shared_fs.values.begin(), fs.size() * sizeof(feature_value)) != 0 ||
+        std::memcmp(fs.indices.begin(), shared_fs.indices.begin(), fs.size() * sizeof(feature_index)) != 0)
+    { return false; }
+  }
+  return true;
+}
+
+template <bool l1>
+float predict_with_shared_features(VW::workspace& all, VW::example& ec, size_t& num_interacted_features)
+{
+  auto& cache = *ec.shared_features;
+  const size_t split_index = cache.split(*ec.interactions);
+  const auto& split = cache.splits[split_index];
+
+  auto* shared_score = cache.find_score(ec.ft_offset, split_index);
+  if (shared_score == nullptr)
+  {
+    VW::example& shared = *cache.shared;
+    cache.indices.clear();
+    for (auto ns : shared.indices)
+    {
+      if (cache.is_shared_namespace[ns]) { cache.indices.push_back(ns); }
+    }
+
+    auto& initial = shared._reduction_features.template get<simple_label_reduction_features>().initial;
+    const float saved_initial = initial;
+    const uint64_t saved_offset = shared.ft_offset;
+    initial = 0.f;
+    shared.ft_offset = ec.ft_offset;
+    auto restore_guard = VW::scope_exit([&shared, &initial, saved_initial, saved_offset] {
+      initial = saved_initial;
+      shared.ft_offset = saved_offset;
+    });
+
+    size_t shared_interacted_features = 0;
+    const float score = predict_subset<l1>(all, shared, cache, split.shared_only, shared_interacted_features);
+    cache.scores.push_back({ec.ft_offset, split_index, score, shared_interacted_features});
+    shared_score = &cache.scores.back();
+  }
+
+  cache.indices.clear();
+  for (auto ns : ec.indices)
+  {
+    if (!cache.is_shared_namespace[ns]) { cache.indices.push_back(ns); }
+  }
+  const float score = predict_subset<l1>(all, ec, cache, split.remaining, num_interacted_features);
+  num_interacted_features += shared_score->num_interacted_features;
+  return score + shared_score->score;
+}
+
 template <bool l1, bool audit>
 void predict(gd& g, base_learner&, VW::example& ec)
 {
@@ -364,10 +491,11 @@ void predict(gd& g, base_learner&, VW::example& ec)
 
   VW::workspace& all = *g.all;
   size_t num_interacted_features = 0;
-  if (l1) { ec.partial_prediction = trunc_predict(all, ec, all.sd->gravity, num_interacted_features); }
+  if (ec.shared_features != nullptr && has_unchanged_shared_namespaces(ec, *ec.shared_features))
+  { ec.partial_prediction = predict_with_shared_features<l1>(all, ec, num_interacted_features); }
   else
   {
-    ec.partial_prediction = inline_predict(all, ec, num_interacted_features);
+    ec.partial_prediction = predict_terms<l1>(all, ec, num_interacted_features);
   }
 
   ec.num_features_from_interactions = num_interacted_features;
@@ -862,9 +990,158 @@ void save_load_regressor(VW::workspace& all, io_buf& model_file, bool read, bool
   }
 }
 
+namespace
+{
+// Header of the weight section of a --dense_model_weights model. The weight table follows after `padding` zero bytes,
+// at a stream offset which is a multiple of DENSE_WEIGHTS_ALIGNMENT so that it can be mapped straight from the file.
+struct dense_weights_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t stride_shift;
+  uint64_t weight_count;
+  uint64_t padding;
+};
+
+constexpr char DENSE_WEIGHTS_MAGIC[8] = {'V', 'W', 'D', 'E', 'N', 'S', 'E', '\0'};
+constexpr uint32_t DENSE_WEIGHTS_VERSION = 1;
+constexpr uint64_t DENSE_WEIGHTS_ALIGNMENT = static_cast<uint64_t>(1) << 16;
+// Number of floats moved through the io_buf at a time, a multiple of every supported stride.
+constexpr uint64_t DENSE_WEIGHTS_CHUNK = static_cast<uint64_t>(1) << 16;
+constexpr uint32_t DENSE_WEIGHTS_MAX_STRIDE_SHIFT = 16;
+
+void write_dense_weights(VW::workspace& all, io_buf& model_file, bool weights_only)
+{
+  auto& weights = all.weights.dense_weights;
+#ifdef PRIVACY_ACTIVATION
+  if (all.privacy_activation) { THROW("--dense_model_weights is not supported with --privacy_activation"); }
+#endif
+
+  dense_weights_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DENSE_WEIGHTS_MAGIC, sizeof(header.magic));
+  header.version = DENSE_WEIGHTS_VERSION;
+  header.stride_shift = weights.stride_shift();
+  header.weight_count = weights.mask() + 1;
+  const uint64_t unpadded_offset = model_file.stream_offset() + sizeof(header);
+  header.padding = (DENSE_WEIGHTS_ALIGNMENT - unpadded_offset % DENSE_WEIGHTS_ALIGNMENT) % DENSE_WEIGHTS_ALIGNMENT;
+
+  model_file.bin_write_fixed(reinterpret_cast<const char*>(&header), sizeof(header));
+  std::vector<char> padding(static_cast<size_t>(header.padding), 0);
+  model_file.bin_write_fixed(padding.data(), padding.size());
+
+  const uint64_t stride = weights.stride();
+  std::vector<weight> chunk;
+  for (uint64_t begin = 0; begin < header.weight_count; begin += DENSE_WEIGHTS_CHUNK)
+  {
+    const auto count = static_cast<size_t>(std::min(DENSE_WEIGHTS_CHUNK, header.weight_count - begin));
+    const weight* source = weights.first() + begin;
+    if (weights_only && stride > 1)
+    {
+      // Like the (index, weight) records, a model without online state only keeps the weights themselves.
+      chunk.assign(count, 0.f);
+      for (size_t i = 0; i < count; i += stride) { chunk[i] = source[i]; }
+      source = chunk.data();
+    }
+    model_file.bin_write_fixed(reinterpret_cast<const char*>(source), count * sizeof(weight));
+  }
+}
+
+#ifndef _WIN32
+// The weights are always the last thing in a model file, so once they are mapped nothing needs to read past them.
+bool map_dense_weights(io_buf& model_file, dense_parameters& weights, const dense_weights_header& header)
+{
+  if (model_file.num_input_files() != 1) { return false; }
+  const int fd = model_file.get_input_files()[0]->file_descriptor();
+  const uint64_t offset = model_file.stream_offset();
+  const uint64_t bytes = header.weight_count * sizeof(weight);
+  struct stat info;
+  if (fd < 0 || offset % DENSE_WEIGHTS_ALIGNMENT != 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+      static_cast<uint64_t>(info.st_size) < offset + bytes)
+  { return false; }
+
+  // The stream offset only matches the file offset if the file was read from its start, which the header confirms.
+  dense_weights_header on_disk;
+  const auto header_offset = static_cast<off_t>(offset - header.padding - sizeof(header));
+  if (pread(fd, &on_disk, sizeof(on_disk), header_offset) != static_cast<ssize_t>(sizeof(on_disk)) ||
+      memcmp(&on_disk, &header, sizeof(header)) != 0)
+  { return false; }
+
+  weights.map_copy_on_write(fd, offset, static_cast<size_t>(header.weight_count >> header.stride_shift),
+      header.stride_shift);
+  return true;
+}
+#endif
+
+void read_dense_weights(VW::workspace& all, io_buf& model_file, bool weights_only)
+{
+  auto& weights = all.weights.dense_weights;
+  const uint64_t length = static_cast<uint64_t>(1) << all.num_bits;
+
+  dense_weights_header header;
+  if (model_file.bin_read_fixed(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, DENSE_WEIGHTS_MAGIC, sizeof(header.magic)) != 0)
+  { THROW("Model content is corrupted, dense weight section not found"); }
+  if (header.version != DENSE_WEIGHTS_VERSION)
+  { THROW("Model dense weight section has unsupported version " << header.version); }
+  if (header.stride_shift > DENSE_WEIGHTS_MAX_STRIDE_SHIFT || header.weight_count != (length << header.stride_shift) ||
+      header.padding >= DENSE_WEIGHTS_ALIGNMENT)
+  { THROW("Model content is corrupted, dense weight section header is inconsistent"); }
+  if (!weights_only && header.stride_shift != weights.stride_shift())
+  {
+    THROW("Model online state was saved with a weight stride of " << (1 << header.stride_shift)
+                                                                   << " but the current options use " << weights.stride());
+  }
+
+  std::vector<char> padding(static_cast<size_t>(header.padding));
+  if (model_file.bin_read_fixed(padding.data(), padding.size()) != padding.size())
+  { THROW("Model content is corrupted, dense weight section is truncated"); }
+
+  // Learning from a model without online state starts that state from its defaults, so only the weights are copied.
+  const bool whole_table = header.stride_shift == weights.stride_shift() && (!weights_only || !all.training);
+#ifndef _WIN32
+  // Mapping is only worth it when the weights are not about to be rewritten by learning.
+  if (whole_table && !all.training && map_dense_weights(model_file, weights, header)) { return; }
+#endif
+
+  const uint64_t file_stride = static_cast<uint64_t>(1) << header.stride_shift;
+  std::vector<weight> chunk;
+  for (uint64_t begin = 0; begin < header.weight_count; begin += DENSE_WEIGHTS_CHUNK)
+  {
+    const auto count = static_cast<size_t>(std::min(DENSE_WEIGHTS_CHUNK, header.weight_count - begin));
+    const size_t bytes = count * sizeof(weight);
+    if (whole_table)
+    {
+      if (model_file.bin_read_fixed(reinterpret_cast<char*>(weights.first() + begin), bytes) != bytes)
+      { THROW("Model content is corrupted, dense weight section is truncated"); }
+    }
+    else
+    {
+      chunk.resize(count);
+      if (model_file.bin_read_fixed(reinterpret_cast<char*>(chunk.data()), bytes) != bytes)
+      { THROW("Model content is corrupted, dense weight section is truncated"); }
+      for (size_t i = 0; i < count; i += file_stride)
+      { weights.strided_index((begin + i) >> header.stride_shift) = chunk[i]; }
+    }
+  }
+}
+}  // namespace
+
+// Binary --dense_model_weights models store the whole weight table, including any online state, as one section instead
+// of (index, weight) records. weights_only models store zeros in place of the online state.
+void save_load_dense_weights(VW::workspace& all, io_buf& model_file, bool read, bool weights_only)
+{
+  if (read) { read_dense_weights(all, model_file, weights_only); }
+  else
+  {
+    write_dense_weights(all, model_file, weights_only);
+  }
+}
+
 void save_load_regressor(VW::workspace& all, io_buf& model_file, bool read, bool text)
 {
-  if (all.weights.sparse) { save_load_regressor(all, model_file, read, text, all.weights.sparse_weights); }
+  if (all.dense_model_weights && !text) { save_load_dense_weights(all, model_file, read, true); }
+  else if (all.weights.sparse) { save_load_regressor(all, model_file, read, text, all.weights.sparse_weights); }
   else
   {
     save_load_regressor(all, model_file, read, text, all.weights.dense_weights);
@@ -1139,7 +1416,8 @@ void save_load_online_state(
     all.sd->total_features = 0;
     all.current_pass = 0;
   }
-  if (all.weights.sparse)
+  if (all.dense_model_weights && !text) { save_load_dense_weights(all, model_file, read, false); }
+  else if (all.weights.sparse)
   { save_load_online_state(all, model_file, read, text, g, msg, ftrl_size, all.weights.sparse_weights); }
   else
   {
@@ -1150,7 +1428,13 @@ void save_load_online_state(
 void save_load(gd& g, io_buf& model_file, bool read, bool text)
 {
   VW::workspace& all = *g.all;
-  if (read)
+  const bool shared_weights = read && !all.shared_weights_input.empty();
+  if (shared_weights)
+  {
+    if (all.training) { THROW("--shared_weights maps the weights read only and requires --testonly"); }
+    load_shared_weights(all, all.shared_weights_input);
+  }
+  else if (read)
   {
     initialize_regressor(all);
 
@@ -1181,7 +1465,12 @@ void save_load(gd& g, io_buf& model_file, bool read, bool text)
     std::stringstream msg;
     msg << ":" << resume << "\n";
     bin_text_read_write_fixed(model_file, reinterpret_cast<char*>(&resume), sizeof(resume), read, msg, text);
-    if (resume)
+    if (shared_weights)
+    {
+      // The weights at the end of the model file are superseded by the mapped ones and never read.
+      if (resume) { THROW("--shared_weights requires a model saved with --predict_only_model"); }
+    }
+    else if (resume)
     {
       if (read && all.model_file_ver < VW::version_definitions::VERSION_SAVE_RESUME_FIX)
       {
@@ -1197,7 +1486,7 @@ void save_load(gd& g, io_buf& model_file, bool read, bool text)
       save_load_regressor(all, model_file, read, text);
     }
   }
-  if (!all.training)
+  if (!all.training && !shared_weights)
   {  // If the regressor was saved without --predict_only_model, then when testing we want to
      // materialize the weights.
     sync_weights(all);
@@ -1282,6 +1571,87 @@ uint64_t set_learn(VW::workspace& all, bool feature_mask_off, gd& g)
   }
 }
 
+// A scorer fused with gd using the default update rule, so the calls of the scorer to gd are inlined. These are called
+// with the data of gd, which holds the workspace the scorer needs.
+template <float (*link)(float in), bool invariant>
+void fused_scorer_learn(void* data, base_learner& base, void* ec)
+{
+  gd& g = *static_cast<gd*>(data);
+  VW::reductions::scorer_details::score<true, link>(
+      *g.all, *static_cast<VW::example*>(ec),
+      [&g, &base](VW::example& e) {
+        predict<false, false>(g, base, e);
+        update<false, invariant, true, true, false, 1, 2, 3>(g, base, e);
+      },
+      [&g, &base](VW::example& e) { predict<false, false>(g, base, e); });
+}
+
+template <float (*link)(float in)>
+void fused_scorer_predict(void* data, base_learner& base, void* ec)
+{
+  gd& g = *static_cast<gd*>(data);
+  VW::reductions::scorer_details::score<false, link>(
+      *g.all, *static_cast<VW::example*>(ec), [](VW::example&) {},
+      [&g, &base](VW::example& e) { predict<false, false>(g, base, e); });
+}
+
+template <bool invariant>
+void fused_scorer_update(void* data, base_learner& base, void* ec)
+{
+  gd& g = *static_cast<gd*>(data);
+  auto& e = *static_cast<VW::example*>(ec);
+  g.all->set_minmax(g.all->sd, e.l.simple.label);
+  update<false, invariant, true, true, false, 1, 2, 3>(g, base, e);
+}
+
+// base is the gd learner, which is called with its own increment as step.
+template <float (*link)(float in)>
+void fused_scorer_multipredict(void* data, base_learner& base, void* ec, size_t count, size_t /* step */,
+    VW::polyprediction* pred, bool finalize_predictions)
+{
+  gd& g = *static_cast<gd*>(data);
+  multipredict<false, false>(
+      g, base, *static_cast<VW::example*>(ec), count, base.increment, pred, finalize_predictions);
+  for (size_t c = 0; c < count; c++) { pred[c].scalar = link(pred[c].scalar); }
+}
+
+template <float (*link)(float in)>
+bool set_fused_scorer(gd& g, VW::LEARNER::details::learn_data& fused)
+{
+  if (g.learn == learn<false, true, true, true, false, 1, 2, 3>)
+  {
+    fused.learn_f = fused_scorer_learn<link, true>;
+    fused.update_f = fused_scorer_update<true>;
+  }
+  else if (g.learn == learn<false, false, true, true, false, 1, 2, 3>)
+  {
+    fused.learn_f = fused_scorer_learn<link, false>;
+    fused.update_f = fused_scorer_update<false>;
+  }
+  else
+  {
+    return false;
+  }
+  fused.data = &g;
+  fused.predict_f = fused_scorer_predict<link>;
+  fused.multipredict_f = fused_scorer_multipredict<link>;
+  return true;
+}
+
+bool get_fused_scorer(gd& g, const std::string& link, VW::LEARNER::details::learn_data& fused)
+{
+  // Only the default update rule is fused: adaptive, normalized, --power_t 0.5 and no --l1, --sparse_l2,
+  // --feature_mask, --adax, --audit or --invert_hash.
+  if (g.predict != predict<false, false>) { return false; }
+
+  using namespace VW::reductions::scorer_details;
+  if (link == "identity") { return set_fused_scorer<id>(g, fused); }
+  if (link == "logistic") { return set_fused_scorer<logistic>(g, fused); }
+  if (link == "glf1") { return set_fused_scorer<glf1>(g, fused); }
+  if (link == "poisson") { return set_fused_scorer<expf>(g, fused); }
+  return false;
+}
+
 uint64_t ceil_log_2(uint64_t v)
 {
   if (v == 0) { return 0; }
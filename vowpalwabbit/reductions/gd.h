@@ -10,6 +10,7 @@
 #include "gd_predict.h"
 #include "global_data.h"
 #include "interactions.h"
+#include "learner.h"
 #include "vw_math.h"
 
 namespace VW
@@ -31,6 +32,10 @@ void save_load_regressor(VW::workspace& all, io_buf& model_file, bool read, bool
 void save_load_online_state(VW::workspace& all, io_buf& model_file, bool read, bool text, double& total_weight,
     GD::gd* g = nullptr, uint32_t ftrl_size = 0);
 
+// Sets the learn, predict, update and multipredict functions of a scorer with this link fused with gd, called with the
+// data of gd. Returns false, leaving fused as it was, when gd does not use the default update rule.
+bool get_fused_scorer(gd& g, const std::string& link, VW::LEARNER::details::learn_data& fused);
+
 template <class T>
 struct multipredict_info
 {
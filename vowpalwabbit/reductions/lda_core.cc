@@ -1337,9 +1337,13 @@ base_learner* VW::reductions::lda_setup(VW::setup_base_i& stack_builder)
   size_t minibatch2 = next_pow2(ld->minibatch);
   if (minibatch2 > all.example_parser->example_queue_limit)
   {
-    bool previous_strict_parse = all.example_parser->strict_parse;
+    const parser& previous = *all.example_parser;
+    auto* resized = new parser{minibatch2, previous.strict_parse, previous.example_pool.num_shards()};
+    resized->example_pool.set_high_water(previous.example_pool.high_water());
+    resized->use_example_arena = previous.use_example_arena;
+    resized->compact_features = previous.compact_features;
     delete all.example_parser;
-    all.example_parser = new parser{minibatch2, previous_strict_parse};
+    all.example_parser = resized;
     all.example_parser->_shared_data = all.sd;
   }
 
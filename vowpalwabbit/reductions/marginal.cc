@@ -144,7 +144,7 @@ void make_marginal(data& sm, VW::example& ec)
           if (sm.m_hash_inv)
           {
             std::ostringstream ss;
-            std::vector<VW::audit_strings>& sn = sm.temp[n].space_names;
+            auto& sn = sm.temp[n].space_names;
             ss << sn[inv_hash_idx].ns << "^" << sn[inv_hash_idx].name << "*" << sn[inv_hash_idx + 1].name;
             sm.inverse_hashes.insert(std::make_pair(key, ss.str()));
             inv_hash_idx += 2;
@@ -4,15 +4,29 @@
 
 #include "reductions/metrics.h"
 
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <WinSock2.h>
+#else
+#  include <netinet/in.h>
+#  include <sys/select.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
 #include "crossplat_compat.h"
 #include "debug_log.h"
 #include "learner.h"
 #include "setup_base.h"
+#include "shared_data.h"
 #ifdef BUILD_EXTERNAL_PARSER
 #  include "parse_example_external.h"
 #endif
 #include "global_data.h"
 #include "parser.h"
+#include "reduction_profiler.h"
 #include "scope_exit.h"
 #include "vw/config/options.h"
 #include "vw/io/logger.h"
@@ -20,13 +34,36 @@
 #include <rapidjson/filewritestream.h>
 #include <rapidjson/writer.h>
 
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
 #include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 using namespace VW::config;
 using namespace VW::LEARNER;
 using namespace rapidjson;
 namespace
 {
+// The pool counters are atomic, so they can be read while the parser runs. How fast allocated grows is the rate at
+// which examples are allocated rather than reused. Only in snapshots: allocated and stolen depend on thread timing,
+// and the --extra_metrics file must stay comparable between runs.
+void insert_example_pool_metrics(const parser& p, VW::metric_sink& metrics)
+{
+  const auto stats = p.example_pool.stats();
+  metrics.set_uint("example_pool_size", p.example_pool.size());
+  metrics.set_uint("example_pool_allocated", stats.allocated);
+  metrics.set_uint("example_pool_trimmed", stats.trimmed);
+  metrics.set_uint("example_pool_stolen", stats.stolen);
+}
+
 void insert_dsjson_metrics(
     const dsjson_metrics* ds_metrics, VW::metric_sink& metrics, const std::vector<std::string>& enabled_reductions)
 {
@@ -58,13 +95,6 @@ void insert_dsjson_metrics(
   }
 }
 
-struct metrics_data
-{
-  std::string out_file;
-  size_t learn_count = 0;
-  size_t predict_count = 0;
-};
-
 struct json_metrics_writer : VW::metric_sink_visitor
 {
   json_metrics_writer(Writer<FileWriteStream>& writer) : _writer(writer) { _writer.StartObject(); }
@@ -95,7 +125,7 @@ private:
   Writer<FileWriteStream>& _writer;
 };
 
-void list_to_json_file(const std::string& filename, const VW::metric_sink& metrics, VW::io::logger& logger)
+bool list_to_json_file(const std::string& filename, const VW::metric_sink& metrics, VW::io::logger& logger)
 {
   FILE* fp;
   if (VW::file_open(&fp, filename.c_str(), "wt") == 0)
@@ -107,21 +137,309 @@ void list_to_json_file(const std::string& filename, const VW::metric_sink& metri
     Writer<FileWriteStream> writer(os);
     json_metrics_writer json_writer(writer);
     metrics.visit(json_writer);
+    return true;
   }
-  else
+  logger.err_warn("skipping metrics. could not open file for metrics: {}", filename);
+  return false;
+}
+// Renders metrics in the Prometheus text exposition format. Keys are prefixed with vw_ and every character which is
+// not allowed in a metric name is replaced by an underscore. String metrics become a value label of a constant gauge.
+struct prometheus_text_writer : VW::metric_sink_visitor
+{
+  void int_metric(const std::string& key, uint64_t value) override { write(key, "", std::to_string(value)); }
+  void float_metric(const std::string& key, float value) override
   {
-    logger.err_warn("skipping metrics. could not open file for metrics: {}", filename);
+    if (std::isnan(value)) { write(key, "", "NaN"); }
+    else if (std::isinf(value)) { write(key, "", value > 0.f ? "+Inf" : "-Inf"); }
+    else { write(key, "", fmt::format("{}", value)); }
+  }
+  void string_metric(const std::string& key, const std::string& value) override
+  {
+    std::string escaped;
+    for (char c : value)
+    {
+      if (c == '\n') { escaped += "\\n"; }
+      else
+      {
+        if (c == '\\' || c == '"') { escaped += '\\'; }
+        escaped += c;
+      }
+    }
+    write(key, "{value=\"" + escaped + "\"}", "1");
   }
+  void bool_metric(const std::string& key, bool value) override { write(key, "", value ? "1" : "0"); }
+
+  std::string text;
+
+private:
+  void write(const std::string& key, const std::string& labels, const std::string& value)
+  {
+    std::string name = "vw_";
+    for (char c : key) { name += std::isalnum(static_cast<unsigned char>(c)) != 0 ? c : '_'; }
+    text += "# TYPE " + name + " gauge\n";
+    text += name + labels + " " + value + "\n";
+  }
+};
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+void close_socket(socket_t sock) { closesocket(sock); }
+#else
+using socket_t = int;
+void close_socket(socket_t sock) { close(sock); }
+#endif
+
+// A scraper that hangs up early must not raise SIGPIPE, which would end the whole process. Linux takes a flag on each
+// send, macOS an option on the socket.
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+void disable_sigpipe(socket_t sock)
+{
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<char*>(&on), sizeof(on));
+#else
+  (void)sock;
+#endif
 }
+
+// Publishes the snapshots taken on the learner thread, for --metrics_snapshot_file and --metrics_port.
+//
+// The learner thread only hands a snapshot over, and never waits for it: when the exporter is busy the snapshot is
+// dropped and the next one is taken a few examples later. Writing the file and serving the snapshots happen on threads
+// of their own.
+class metrics_exporter
+{
+public:
+  metrics_exporter(std::string snapshot_file, uint16_t port, VW::io::logger& logger)
+      : _snapshot_file(std::move(snapshot_file)), _logger(logger)
+  {
+    if (port != 0) { _listen_sock = listen_on(port); }
+    _exporter = std::thread([this]() { export_loop(); });
+    if (port != 0) { _server = std::thread([this]() { serve_loop(); }); }
+  }
+
+  ~metrics_exporter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _has_work.notify_one();
+    _exporter.join();
+    if (_server.joinable())
+    {
+      _stop_serving = true;
+      _server.join();
+      close_socket(_listen_sock);
+    }
+  }
+
+  metrics_exporter(const metrics_exporter&) = delete;
+  metrics_exporter& operator=(const metrics_exporter&) = delete;
+
+  // Returns false, without blocking, when the exporter is busy with the previous snapshot.
+  bool publish(VW::metric_sink& snapshot)
+  {
+    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) { return false; }
+    std::swap(_pending, snapshot);
+    _has_pending = true;
+    lock.unlock();
+    _has_work.notify_one();
+    return true;
+  }
+
+private:
+  static socket_t listen_on(uint16_t port)
+  {
+#ifdef _WIN32
+    WSAData wsaData;
+    int lastError = WSAStartup(MAKEWORD(2, 2), &wsaData);
+    if (lastError != 0) THROWERRNO("WSAStartup() returned error:" << lastError);
+#endif
+    socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+    if (static_cast<int>(sock) < 0) { THROW(fmt::format("socket: {}", VW::strerror_to_string(errno))); }
+
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&on), sizeof(on));
+
+    sockaddr_in address;
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(sock, 8) < 0)
+    {
+      const auto error = VW::strerror_to_string(errno);
+      close_socket(sock);
+      THROW(fmt::format("metrics_port: could not listen on port {}: {}", port, error));
+    }
+    return sock;
+  }
+
+  // Waits at most timeout_ms for sock to be readable.
+  static bool wait_readable(socket_t sock, long timeout_ms)
+  {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(sock, &fds);
+    timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+    return select(static_cast<int>(sock) + 1, &fds, nullptr, nullptr, &timeout) > 0;
+  }
+
+  void export_loop()
+  {
+    VW::metric_sink snapshot;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+      _has_work.wait(lock, [this]() { return _stop || _has_pending; });
+      // The last snapshot is still written when stopping.
+      if (!_has_pending) { break; }
+      std::swap(snapshot, _pending);
+      _has_pending = false;
+      lock.unlock();
+
+      if (!_snapshot_file.empty())
+      {
+        // Written next to the file and renamed over it, so readers never see a partial snapshot.
+        const std::string tmp_file = _snapshot_file + ".tmp";
+        if (list_to_json_file(tmp_file, snapshot, _logger))
+        {
+#ifdef _WIN32
+          std::remove(_snapshot_file.c_str());
+#endif
+          if (std::rename(tmp_file.c_str(), _snapshot_file.c_str()) != 0)
+          { _logger.err_warn("could not write metrics snapshot: {}", _snapshot_file); }
+        }
+      }
+      if (_server.joinable())
+      {
+        prometheus_text_writer writer;
+        snapshot.visit(writer);
+        std::lock_guard<std::mutex> text_lock(_text_mutex);
+        _text = std::move(writer.text);
+      }
+
+      lock.lock();
+    }
+  }
+
+  void serve_loop()
+  {
+    while (!_stop_serving)
+    {
+      if (!wait_readable(_listen_sock, 200)) { continue; }
+      socket_t client = accept(_listen_sock, nullptr, nullptr);
+      if (static_cast<int>(client) < 0) { continue; }
+      disable_sigpipe(client);
+
+      // Whatever is asked, the latest snapshot is returned.
+      std::array<char, 4096> request;
+      if (wait_readable(client, 1000)) { recv(client, request.data(), static_cast<int>(request.size()), 0); }
+
+      std::string body;
+      {
+        std::lock_guard<std::mutex> text_lock(_text_mutex);
+        body = _text;
+      }
+      const std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+          std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+      size_t sent = 0;
+      while (sent < response.size())
+      {
+        const auto n = send(client, response.data() + sent, static_cast<int>(response.size() - sent), SEND_FLAGS);
+        // The client went away, the next one gets the snapshot.
+        if (n <= 0) { break; }
+        sent += static_cast<size_t>(n);
+      }
+      close_socket(client);
+    }
+  }
+
+  std::string _snapshot_file;
+  VW::io::logger& _logger;
+
+  std::mutex _mutex;
+  std::condition_variable _has_work;
+  bool _stop = false;
+  bool _has_pending = false;
+  VW::metric_sink _pending;
+  std::thread _exporter;
+
+  socket_t _listen_sock{};
+  std::atomic<bool> _stop_serving{false};
+  std::mutex _text_mutex;
+  std::string _text;  // latest snapshot, in the Prometheus text format
+  std::thread _server;
+};
+
+// Snapshots are considered every this many calls, which keeps reading the clock off the hot path.
+constexpr size_t SNAPSHOT_CHECK_PERIOD = 64;
+
+struct metrics_data
+{
+  std::string out_file;
+  size_t learn_count = 0;
+  size_t predict_count = 0;
+  std::unique_ptr<VW::reduction_profiler> profiler;  // set with --profile_reductions
+
+  // Periodic snapshots, set with --metrics_snapshot_file or --metrics_port.
+  VW::workspace* all = nullptr;
+  std::chrono::steady_clock::duration snapshot_interval{};
+  std::chrono::steady_clock::time_point last_snapshot;
+  size_t last_snapshot_count = 0;
+  std::unique_ptr<metrics_exporter> exporter;
+};
+
 void persist(metrics_data& data, VW::metric_sink& metrics)
 {
   metrics.set_uint("total_predict_calls", data.predict_count);
   metrics.set_uint("total_learn_calls", data.learn_count);
+  if (data.profiler != nullptr) { data.profiler->persist_metrics(metrics); }
+}
+
+// Counters which the learner thread owns, so they can be read between two examples. The dsjson metrics are left to
+// --extra_metrics since the parser thread updates them.
+void take_snapshot(metrics_data& data)
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (now - data.last_snapshot < data.snapshot_interval) { return; }
+
+  VW::workspace& all = *data.all;
+  VW::metric_sink snapshot;
+  all.l->persist_metrics(snapshot);
+
+  const size_t count = data.learn_count + data.predict_count;
+  const double seconds = std::chrono::duration<double>(now - data.last_snapshot).count();
+  snapshot.set_float("examples_per_second", static_cast<float>((count - data.last_snapshot_count) / seconds));
+  snapshot.set_uint("parse_queue_depth", all.example_parser->ready_parsed_examples.size());
+  insert_example_pool_metrics(*all.example_parser, snapshot);
+  snapshot.set_uint("examples", all.sd->example_number);
+  snapshot.set_float("weighted_examples", static_cast<float>(all.sd->weighted_examples()));
+  const double weighted_labeled = all.sd->weighted_labeled_examples;
+  snapshot.set_float(
+      "average_loss", weighted_labeled > 0. ? static_cast<float>(all.sd->sum_loss / weighted_labeled) : 0.f);
+
+  if (data.exporter->publish(snapshot))
+  {
+    data.last_snapshot = now;
+    data.last_snapshot_count = count;
+  }
 }
 
 template <bool is_learn, typename T, typename E>
 void predict_or_learn(metrics_data& data, T& base, E& ec)
 {
+  if (data.exporter != nullptr && (data.learn_count + data.predict_count) % SNAPSHOT_CHECK_PERIOD == 0)
+  { take_snapshot(data); }
+
   if (is_learn)
   {
     data.learn_count++;
@@ -162,38 +480,82 @@ VW::LEARNER::base_learner* VW::reductions::metrics_setup(VW::setup_base_i& stack
 {
   options_i& options = *stack_builder.get_options();
   auto data = VW::make_unique<metrics_data>();
+  bool profile_reductions = false;
+  std::string snapshot_file;
+  uint32_t metrics_port = 0;
+  float snapshot_interval = 10.f;
 
   option_group_definition new_options("[Reduction] Debug Metrics");
-  new_options.add(make_option("extra_metrics", data->out_file)
-                      .necessary()
-                      .help("Specify filename to write metrics to. Note: There is no fixed schema"));
+  new_options
+      .add(make_option("extra_metrics", data->out_file)
+               .help("Specify filename to write metrics to. Note: There is no fixed schema"))
+      .add(make_option("profile_reductions", profile_reductions)
+               .help("Time the learn, predict and finish_example calls of each reduction and add them to the "
+                     "metrics output"))
+      .add(make_option("metrics_snapshot_file", snapshot_file)
+               .help("Periodically replace this file with a JSON snapshot of the metrics, including throughput, "
+                     "parse queue depth and average loss"))
+      .add(make_option("metrics_port", metrics_port)
+               .help("Serve the latest metrics snapshot in the Prometheus text format over HTTP on this port"))
+      .add(make_option("metrics_snapshot_interval", snapshot_interval)
+               .default_value(10.f)
+               .help("Seconds between two metrics snapshots"));
+  options.add_and_parse(new_options);
 
-  if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
+  const bool snapshots = options.was_supplied("metrics_snapshot_file") || options.was_supplied("metrics_port");
+  if (!options.was_supplied("extra_metrics") && !snapshots)
+  {
+    if (profile_reductions)
+      THROW("--profile_reductions requires --extra_metrics, --metrics_snapshot_file or --metrics_port");
+    return nullptr;
+  }
+
+  if (options.was_supplied("extra_metrics") && data->out_file.empty())
+    THROW("extra_metrics argument (output filename) is missing.");
+  if (snapshots)
+  {
+    if (options.was_supplied("metrics_snapshot_file") && snapshot_file.empty())
+      THROW("metrics_snapshot_file argument (output filename) is missing.");
+    if (metrics_port > UINT16_MAX) THROW("metrics_port must be a valid TCP port, got " << metrics_port);
+    if (!(snapshot_interval > 0.f)) THROW("metrics_snapshot_interval must be positive, got " << snapshot_interval);
 
-  if (data->out_file.empty()) THROW("extra_metrics argument (output filename) is missing.");
+    auto* all = stack_builder.get_all_pointer();
+    data->all = all;
+    data->snapshot_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(snapshot_interval));
+    data->last_snapshot = std::chrono::steady_clock::now();
+    data->exporter =
+        VW::make_unique<metrics_exporter>(snapshot_file, static_cast<uint16_t>(metrics_port), all->logger);
+  }
 
   auto* base_learner = stack_builder.setup_base_learner();
+  if (profile_reductions) { data->profiler = VW::make_unique<VW::reduction_profiler>(); }
+  auto* profiler = data->profiler.get();
 
+  VW::LEARNER::base_learner* l = nullptr;
   if (base_learner->is_multiline())
   {
-    auto* l = make_reduction_learner(std::move(data), as_multiline(base_learner),
+    l = make_base(*make_reduction_learner(std::move(data), as_multiline(base_learner),
         predict_or_learn<true, multi_learner, multi_ex>, predict_or_learn<false, multi_learner, multi_ex>,
         stack_builder.get_setupfn_name(metrics_setup))
-                  .set_output_prediction_type(base_learner->get_output_prediction_type())
-                  .set_learn_returns_prediction(base_learner->learn_returns_prediction)
-                  .set_persist_metrics(persist)
-                  .build();
-    return make_base(*l);
+                       .set_output_prediction_type(base_learner->get_output_prediction_type())
+                       .set_learn_returns_prediction(base_learner->learn_returns_prediction)
+                       .set_persist_metrics(persist)
+                       .build());
   }
   else
   {
-    auto* l = make_reduction_learner(std::move(data), as_singleline(base_learner),
+    l = make_base(*make_reduction_learner(std::move(data), as_singleline(base_learner),
         predict_or_learn<true, single_learner, example>, predict_or_learn<false, single_learner, example>,
         stack_builder.get_setupfn_name(metrics_setup))
-                  .set_output_prediction_type(base_learner->get_output_prediction_type())
-                  .set_learn_returns_prediction(base_learner->learn_returns_prediction)
-                  .set_persist_metrics(persist)
-                  .build();
-    return make_base(*l);
+                       .set_output_prediction_type(base_learner->get_output_prediction_type())
+                       .set_learn_returns_prediction(base_learner->learn_returns_prediction)
+                       .set_persist_metrics(persist)
+                       .build());
   }
+
+  // The reductions below are instrumented once this one is built, so it keeps calling their original functions
+  // where it forwards to them.
+  if (profiler != nullptr) { profiler->instrument(*l); }
+  return l;
 }
@@ -0,0 +1,325 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "reductions/parameter_server.h"
+
+#include "gd.h"
+#include "global_data.h"
+#include "learner.h"
+#include "network.h"
+#include "setup_base.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/options.h"
+#include "vw/io/logger.h"
+#include "vw/parameter_server/parameter_server.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace VW::config;
+namespace ps = VW::parameter_server_protocol;
+
+namespace
+{
+struct shard
+{
+  socket_t sock;
+  uint64_t begin;  // first (pre-stride) weight index owned by this server
+  uint64_t count;
+  bool empty;  // no worker had connected to the server before, it holds zeros
+};
+
+struct parameter_server_client
+{
+  VW::workspace* all = nullptr;
+  std::vector<shard> shards;
+  uint64_t sync_period = 0;
+  uint64_t learn_count = 0;
+  bool initialized = false;
+
+  // Whether learning only changes the weights of the features of the example, so that syncing those is enough.
+  bool sync_touched_only = false;
+  uint32_t stride_shift = 0;
+  uint64_t mask = 0;
+  std::vector<bool> touched;
+  std::vector<uint64_t> touched_indices;
+
+  // Value of each synced weight as of the last pull, the difference to the current weight is what gets pushed.
+  std::vector<float> snapshot;
+  std::vector<ps::push_record> pending;
+  std::vector<uint64_t> indices;
+  std::vector<float> pulled;
+
+  ~parameter_server_client()
+  {
+    for (auto& s : shards)
+    {
+      auto op = ps::opcode::close;
+      ps::send_all(s.sock, &op, sizeof(op));
+      CLOSESOCK(s.sock);
+    }
+  }
+};
+
+void connect_shards(parameter_server_client& c, const std::vector<std::string>& hosts)
+{
+  const uint64_t num_weights = c.all->length();
+  const uint64_t num_shards = hosts.size();
+  for (uint64_t i = 0; i < num_shards; i++)
+  {
+    std::string host = hosts[i];
+    if (host.find(':') == std::string::npos) { host += ":" + std::to_string(ps::DEFAULT_PORT); }
+
+    shard s;
+    s.begin = i * num_weights / num_shards;
+    s.count = (i + 1) * num_weights / num_shards - s.begin;
+    s.sock = static_cast<socket_t>(open_socket(host.c_str(), c.all->logger));
+    VW::details::disable_sigpipe(s.sock);
+    c.shards.push_back(s);
+
+    auto reply = ps::shard_reply::rejected;
+    if (!ps::send_all(s.sock, &s.count, sizeof(s.count)) || !ps::recv_all(s.sock, &reply, sizeof(reply)))
+    { THROW("parameter server " << host << " closed the connection during the handshake"); }
+    if (reply == ps::shard_reply::rejected)
+    { THROW("parameter server " << host << " rejected shard of " << s.count << " weights, check that -b matches"); }
+    c.shards.back().empty = reply == ps::shard_reply::accepted_empty;
+  }
+  c.snapshot.resize(static_cast<size_t>(num_weights), 0.f);
+  if (c.sync_touched_only) { c.touched.resize(static_cast<size_t>(num_weights), false); }
+}
+
+void mark_touched(parameter_server_client& c, float, uint64_t index)
+{
+  const auto i = static_cast<size_t>((index >> c.stride_shift) & c.mask);
+  if (!c.touched[i])
+  {
+    c.touched[i] = true;
+    c.touched_indices.push_back(i);
+  }
+}
+
+void clear_touched(parameter_server_client& c)
+{
+  for (auto i : c.touched_indices) { c.touched[static_cast<size_t>(i)] = false; }
+  c.touched_indices.clear();
+}
+
+// Fills indices with the touched weights of the shard, relative to its first weight.
+void touched_in_shard(parameter_server_client& c, const shard& s)
+{
+  c.indices.clear();
+  for (auto i : c.touched_indices)
+  {
+    if (i >= s.begin && i < s.begin + s.count) { c.indices.push_back(i - s.begin); }
+  }
+}
+
+void add_delta(parameter_server_client& c, const shard& s, uint64_t i)
+{
+  const auto index = static_cast<size_t>(s.begin + i);
+  float delta = c.all->weights.dense_weights.strided_index(index) - c.snapshot[index];
+  if (delta != 0.f) { c.pending.push_back({i, delta}); }
+}
+
+void send_pending(parameter_server_client& c, const shard& s)
+{
+  if (c.pending.empty()) { return; }
+
+  auto op = ps::opcode::push;
+  uint64_t count = c.pending.size();
+  if (!ps::send_all(s.sock, &op, sizeof(op)) || !ps::send_all(s.sock, &count, sizeof(count)) ||
+      !ps::send_all(s.sock, c.pending.data(), c.pending.size() * sizeof(ps::push_record)))
+  { THROW("lost connection to parameter server while pushing updates"); }
+}
+
+void push(parameter_server_client& c, const shard& s)
+{
+  c.pending.clear();
+  for (uint64_t i = 0; i < s.count; i++) { add_delta(c, s, i); }
+  send_pending(c, s);
+}
+
+void push_touched(parameter_server_client& c, const shard& s)
+{
+  c.pending.clear();
+  for (auto i : c.indices) { add_delta(c, s, i); }
+  send_pending(c, s);
+}
+
+// Pushes all weights of the shard to a server holding zeros, after which it holds what the worker holds.
+void seed(parameter_server_client& c, const shard& s)
+{
+  push(c, s);
+  for (uint64_t i = 0; i < s.count; i++)
+  {
+    const auto index = static_cast<size_t>(s.begin + i);
+    c.snapshot[index] = c.all->weights.dense_weights.strided_index(index);
+  }
+}
+
+void set_pulled(parameter_server_client& c, const shard& s, uint64_t i, float value)
+{
+  const auto index = static_cast<size_t>(s.begin + i);
+  c.all->weights.dense_weights.strided_index(index) = value;
+  c.snapshot[index] = value;
+}
+
+void pull(parameter_server_client& c, const shard& s)
+{
+  auto op = ps::opcode::pull;
+  uint64_t range[2] = {0, s.count};
+  c.pulled.resize(static_cast<size_t>(s.count));
+  if (!ps::send_all(s.sock, &op, sizeof(op)) || !ps::send_all(s.sock, range, sizeof(range)) ||
+      !ps::recv_all(s.sock, c.pulled.data(), c.pulled.size() * sizeof(float)))
+  { THROW("lost connection to parameter server while pulling weights"); }
+
+  for (uint64_t i = 0; i < s.count; i++) { set_pulled(c, s, i, c.pulled[static_cast<size_t>(i)]); }
+}
+
+void pull_touched(parameter_server_client& c, const shard& s)
+{
+  if (c.indices.empty()) { return; }
+
+  auto op = ps::opcode::pull_indices;
+  uint64_t count = c.indices.size();
+  if (!ps::send_all(s.sock, &op, sizeof(op)) || !ps::send_all(s.sock, &count, sizeof(count)))
+  { THROW("lost connection to parameter server while pulling weights"); }
+
+  // The server answers each batch before reading the next one, so neither side blocks on a full socket buffer.
+  for (size_t begin = 0; begin < c.indices.size(); begin += ps::PUSH_BATCH_SIZE)
+  {
+    const size_t batch = std::min(c.indices.size() - begin, ps::PUSH_BATCH_SIZE);
+    c.pulled.resize(batch);
+    if (!ps::send_all(s.sock, c.indices.data() + begin, batch * sizeof(uint64_t)) ||
+        !ps::recv_all(s.sock, c.pulled.data(), batch * sizeof(float)))
+    { THROW("lost connection to parameter server while pulling weights"); }
+    for (size_t i = 0; i < batch; i++) { set_pulled(c, s, c.indices[begin + i], c.pulled[i]); }
+  }
+}
+
+// Pushes the weights of a loaded model to the servers nobody talked to yet, and pulls the others.
+void initialize(parameter_server_client& c)
+{
+  bool replaced_model = false;
+  for (const auto& s : c.shards)
+  {
+    if (s.empty) { seed(c, s); }
+    else
+    {
+      pull(c, s);
+      replaced_model = true;
+    }
+  }
+  clear_touched(c);
+  c.initialized = true;
+
+  if (replaced_model && !c.all->initial_regressors.empty())
+  {
+    c.all->logger.err_warn(
+        "The parameter servers already hold weights from other workers, they replace the model loaded with -i");
+  }
+}
+
+void sync(parameter_server_client& c, bool full)
+{
+  if (full || !c.sync_touched_only)
+  {
+    for (const auto& s : c.shards) { push(c, s); }
+    for (const auto& s : c.shards) { pull(c, s); }
+  }
+  else
+  {
+    for (const auto& s : c.shards)
+    {
+      touched_in_shard(c, s);
+      push_touched(c, s);
+      pull_touched(c, s);
+    }
+  }
+  clear_touched(c);
+}
+
+void learn(parameter_server_client& c, VW::LEARNER::single_learner& base, VW::example& ec)
+{
+  if (!c.initialized) { initialize(c); }
+  base.learn(ec);
+  if (c.sync_touched_only) { GD::foreach_feature<parameter_server_client, uint64_t, mark_touched>(*c.all, ec, c); }
+  if (++c.learn_count % c.sync_period == 0) { sync(c, false); }
+}
+
+void predict(parameter_server_client&, VW::LEARNER::single_learner& base, VW::example& ec) { base.predict(ec); }
+
+// Pulls the whole shard once per pass, which also brings in the weights only other workers learned.
+void end_pass(parameter_server_client& c)
+{
+  if (c.initialized) { sync(c, true); }
+}
+
+void end_examples(parameter_server_client& c)
+{
+  if (c.initialized) { sync(c, true); }
+}
+
+// Optimizers which only update the weights of the features of the example they learn.
+bool updates_features_only(const VW::workspace& all, const std::string& base_name)
+{
+  if (all.l1_lambda > 0.f || all.l2_lambda > 0.f) { return false; }
+  return base_name == "gd" || base_name == "freegrad" || base_name.compare(0, 5, "ftrl-") == 0;
+}
+}  // namespace
+
+VW::LEARNER::base_learner* VW::reductions::parameter_server_setup(VW::setup_base_i& stack_builder)
+{
+  options_i& options = *stack_builder.get_options();
+  VW::workspace& all = *stack_builder.get_all_pointer();
+  std::string servers;
+  uint64_t sync_period = 0;
+
+  option_group_definition new_options("[Reduction] Parameter Server");
+  new_options
+      .add(make_option("ps_servers", servers)
+               .keep()
+               .necessary()
+               .help("Train asynchronously against the given comma separated list of parameter servers "
+                     "(host[:port]). The weight table is sharded evenly across the servers"))
+      .add(make_option("ps_sync_period", sync_period)
+               .default_value(64)
+               .help("Number of learned examples between pushing local updates to and pulling fresh weights from "
+                     "the parameter servers"));
+
+  if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
+
+  if (sync_period == 0) { THROW("--ps_sync_period must be positive"); }
+  if (all.weights.sparse) { THROW("--ps_servers is not compatible with --sparse_weights"); }
+
+  std::vector<std::string> hosts;
+  size_t start = 0;
+  while (start <= servers.size())
+  {
+    auto end = servers.find(',', start);
+    if (end == std::string::npos) { end = servers.size(); }
+    if (end > start) { hosts.push_back(servers.substr(start, end - start)); }
+    start = end + 1;
+  }
+  if (hosts.empty()) { THROW("--ps_servers requires at least one host"); }
+
+  auto base = as_singleline(stack_builder.setup_base_learner());
+
+  auto data = VW::make_unique<parameter_server_client>();
+  data->all = &all;
+  data->sync_period = sync_period;
+  data->sync_touched_only = updates_features_only(all, base->get_name());
+  data->stride_shift = all.weights.stride_shift();
+  data->mask = all.weights.mask() >> all.weights.stride_shift();
+  connect_shards(*data, hosts);
+
+  auto* l = make_reduction_learner(
+      std::move(data), base, learn, predict, stack_builder.get_setupfn_name(parameter_server_setup))
+                .set_learn_returns_prediction(base->learn_returns_prediction)
+                .set_end_pass(end_pass)
+                .set_end_examples(end_examples)
+                .build();
+  return make_base(*l);
+}
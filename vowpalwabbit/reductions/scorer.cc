@@ -4,16 +4,12 @@
 
 #include "reductions/scorer.h"
 
-#include "correctedMath.h"
 #include "global_data.h"
 #include "learner.h"
-#include "loss_functions.h"
 #include "setup_base.h"
 #include "vw/common/vw_exception.h"
 #include "vw/config/options.h"
 
-#include <cfloat>
-
 #undef VW_DEBUG_LOG
 #define VW_DEBUG_LOG vw_dbg::scorer
 
@@ -30,20 +26,8 @@ struct scorer
 template <bool is_learn, float (*link)(float in)>
 void predict_or_learn(scorer& s, VW::LEARNER::single_learner& base, VW::example& ec)
 {
-  // Predict does not need set_minmax
-  if (is_learn) { s.all->set_minmax(s.all->sd, ec.l.simple.label); }
-
-  bool learn = is_learn && ec.l.simple.label != FLT_MAX && ec.weight > 0;
-  if (learn) { base.learn(ec); }
-  else
-  {
-    base.predict(ec);
-  }
-
-  if (ec.weight > 0 && ec.l.simple.label != FLT_MAX)
-  { ec.loss = s.all->loss->get_loss(s.all->sd, ec.pred.scalar, ec.l.simple.label) * ec.weight; }
-
-  ec.pred.scalar = link(ec.pred.scalar);
+  VW::reductions::scorer_details::score<is_learn, link>(
+      *s.all, ec, [&base](VW::example& e) { base.learn(e); }, [&base](VW::example& e) { base.predict(e); });
   VW_DBG(ec) << "ex#= " << ec.example_counter << ", offset=" << ec.ft_offset << ", lbl=" << ec.l.simple.label
              << ", pred= " << ec.pred.scalar << ", wt=" << ec.weight << ", gd.raw=" << ec.partial_prediction
              << ", loss=" << ec.loss << std::endl;
@@ -66,16 +50,9 @@ void update(scorer& s, VW::LEARNER::single_learner& base, VW::example& ec)
              << ", loss=" << ec.loss << std::endl;
 }
 
-// y = f(x) -> [0, 1]
-inline float logistic(float in) { return 1.f / (1.f + correctedExp(-in)); }
-
-// http://en.wikipedia.org/wiki/Generalized_logistic_curve
-// where the lower & upper asymptotes are -1 & 1 respectively
-// 'glf1' stands for 'Generalized Logistic Function with [-1,1] range'
-//    y = f(x) -> [-1, 1]
-inline float glf1(float in) { return 2.f / (1.f + correctedExp(-in)) - 1.f; }
-
-inline float id(float in) { return in; }
+using VW::reductions::scorer_details::glf1;
+using VW::reductions::scorer_details::id;
+using VW::reductions::scorer_details::logistic;
 }  // namespace
 
 VW::LEARNER::base_learner* VW::reductions::scorer_setup(VW::setup_base_i& stack_builder)
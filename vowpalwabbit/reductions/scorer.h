@@ -3,12 +3,52 @@
 // license as described in the file LICENSE.
 
 #pragma once
+#include "correctedMath.h"
+#include "example.h"
+#include "global_data.h"
+#include "loss_functions.h"
 #include "vw_fwd.h"
 
+#include <cfloat>
+
 namespace VW
 {
 namespace reductions
 {
 VW::LEARNER::base_learner* scorer_setup(VW::setup_base_i& stack_builder);
+
+namespace scorer_details
+{
+// y = f(x) -> [0, 1]
+inline float logistic(float in) { return 1.f / (1.f + correctedExp(-in)); }
+
+// http://en.wikipedia.org/wiki/Generalized_logistic_curve
+// where the lower & upper asymptotes are -1 & 1 respectively
+// 'glf1' stands for 'Generalized Logistic Function with [-1,1] range'
+//    y = f(x) -> [-1, 1]
+inline float glf1(float in) { return 2.f / (1.f + correctedExp(-in)) - 1.f; }
+
+inline float id(float in) { return in; }
+
+// Scores ec around the prediction of the base, made by learn or predict. Shared by the scorer and the scorer fused
+// with gd, see fused_stacks.h.
+template <bool is_learn, float (*link)(float in), typename LearnT, typename PredictT>
+inline void score(VW::workspace& all, VW::example& ec, LearnT learn, PredictT predict)
+{
+  // Predict does not need set_minmax
+  if (is_learn) { all.set_minmax(all.sd, ec.l.simple.label); }
+
+  if (is_learn && ec.l.simple.label != FLT_MAX && ec.weight > 0) { learn(ec); }
+  else
+  {
+    predict(ec);
+  }
+
+  if (ec.weight > 0 && ec.l.simple.label != FLT_MAX)
+  { ec.loss = all.loss->get_loss(all.sd, ec.pred.scalar, ec.l.simple.label) * ec.weight; }
+
+  ec.pred.scalar = link(ec.pred.scalar);
 }
-}  // namespace VW
\ No newline at end of file
+}  // namespace scorer_details
+}  // namespace reductions
+}  // namespace VW
@@ -10,6 +10,7 @@
 #include "learner.h"
 #include "scope_exit.h"
 #include "setup_base.h"
+#include "shared_feature_cache.h"
 #include "vw.h"
 #include "vw/config/options.h"
 
@@ -27,8 +28,34 @@ struct sfm_data
 {
   std::unique_ptr<sfm_metrics> _metrics;
   VW::label_type_t label_type = VW::label_type_t::cb;
+  VW::shared_feature_cache cache;
 };
 
+// Marks the namespaces of the shared example which gd can score once for all actions. Returns false if there are none,
+// or if an action uses one of them itself, since the merged feature group then mixes shared and action features.
+bool prepare_shared_feature_cache(VW::shared_feature_cache& cache, VW::example& shared, const VW::multi_ex& actions)
+{
+  if (shared.extent_interactions != nullptr && !shared.extent_interactions->empty()) { return false; }
+
+  cache.reset(&shared);
+  bool any_shared = false;
+  for (auto ns : shared.indices)
+  {
+    if (ns == constant_namespace) { continue; }
+    cache.is_shared_namespace[ns] = true;
+    any_shared = true;
+  }
+
+  for (const auto* action : actions)
+  {
+    for (auto ns : action->indices)
+    {
+      if (cache.is_shared_namespace[ns]) { return false; }
+    }
+  }
+  return any_shared;
+}
+
 template <bool is_learn>
 void predict_or_learn(sfm_data& data, VW::LEARNER::multi_learner& base, VW::multi_ex& ec_seq)
 {
@@ -38,21 +65,32 @@ void predict_or_learn(sfm_data& data, VW::LEARNER::multi_learner& base, VW::mult
 
   const bool has_example_header = VW::LEARNER::ec_is_example_header(*ec_seq[0], data.label_type);
 
+  bool cache_shared_features = false;
   if (has_example_header)
   {
     shared_example = ec_seq[0];
     ec_seq.erase(ec_seq.begin());
+    // Nothing learns while predicting, so the score of the shared features stays the same across the actions.
+    cache_shared_features = !is_learn && prepare_shared_feature_cache(data.cache, *shared_example, ec_seq);
     // merge sequences
-    for (auto& example : ec_seq) { LabelDict::add_example_namespaces_from_example(*example, *shared_example); }
+    for (auto& example : ec_seq)
+    {
+      LabelDict::add_example_namespaces_from_example(*example, *shared_example);
+      if (cache_shared_features) { example->shared_features = &data.cache; }
+    }
     std::swap(ec_seq[0]->pred, shared_example->pred);
     std::swap(ec_seq[0]->tag, shared_example->tag);
   }
 
   // Guard example state restore against throws
-  auto restore_guard = VW::scope_exit([has_example_header, &shared_example, &ec_seq] {
+  auto restore_guard = VW::scope_exit([has_example_header, cache_shared_features, &shared_example, &ec_seq] {
     if (has_example_header)
     {
-      for (auto& example : ec_seq) { LabelDict::del_example_namespaces_from_example(*example, *shared_example); }
+      for (auto& example : ec_seq)
+      {
+        LabelDict::del_example_namespaces_from_example(*example, *shared_example);
+        if (cache_shared_features) { example->shared_features = nullptr; }
+      }
       std::swap(shared_example->pred, ec_seq[0]->pred);
       std::swap(shared_example->tag, ec_seq[0]->tag);
       ec_seq.insert(ec_seq.begin(), shared_example);
@@ -0,0 +1,148 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "resolved_setup.h"
+
+#include "global_data.h"
+#include "vw/common/vw_exception.h"
+#include "vw/config/option.h"
+#include "vw/config/options.h"
+
+#include <set>
+#include <sstream>
+
+using namespace VW::config;
+
+namespace
+{
+constexpr const char* SERIALIZED_HEADER = "vw_resolved_setup 1";
+
+// Appends the value of an option to a command line.
+struct option_tokens_writer : typed_option_visitor
+{
+  explicit option_tokens_writer(std::vector<std::string>& tokens) : _tokens(tokens) {}
+
+  void visit(typed_option<uint32_t>& option) override { write(option); }
+  void visit(typed_option<uint64_t>& option) override { write(option); }
+  void visit(typed_option<int64_t>& option) override { write(option); }
+  void visit(typed_option<int32_t>& option) override { write(option); }
+  void visit(typed_option<float>& option) override { write(option); }
+  void visit(typed_option<std::string>& option) override { write(option); }
+
+  void visit(typed_option<bool>& option) override
+  {
+    if (option.value()) { _tokens.push_back("--" + option.m_name); }
+  }
+
+  void visit(typed_option<std::vector<std::string>>& option) override
+  {
+    for (const auto& value : option.value())
+    {
+      _tokens.push_back("--" + option.m_name);
+      _tokens.push_back(value);
+    }
+  }
+
+private:
+  template <typename T>
+  void write(const typed_option<T>& option)
+  {
+    std::ostringstream value;
+    value.precision(17);
+    value << option.value();
+    _tokens.push_back("--" + option.m_name);
+    _tokens.push_back(value.str());
+  }
+
+  std::vector<std::string>& _tokens;
+};
+
+void write_lines(std::ostringstream& output, const std::vector<std::string>& lines)
+{
+  output << lines.size() << '\n';
+  for (const auto& line : lines)
+  {
+    if (line.find('\n') != std::string::npos) { THROW("resolved setup cannot hold a line break: " << line); }
+    output << line << '\n';
+  }
+}
+
+std::vector<std::string> read_lines(std::istringstream& input)
+{
+  std::string line;
+  if (!std::getline(input, line)) { THROW("resolved setup is truncated"); }
+
+  size_t count = 0;
+  try
+  {
+    count = std::stoul(line);
+  }
+  catch (const std::exception&)
+  {
+    THROW("resolved setup has an invalid count: " << line);
+  }
+
+  std::vector<std::string> lines;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!std::getline(input, line)) { THROW("resolved setup is truncated"); }
+    lines.push_back(line);
+  }
+  return lines;
+}
+}  // namespace
+
+namespace VW
+{
+resolved_setup resolve_setup(VW::workspace& all)
+{
+  resolved_setup setup;
+  setup.reductions = all.enabled_setup_functions;
+
+  // Options only defined by reductions that were not enabled are left out, their setup functions will not run.
+  std::set<std::string> tints(setup.reductions.begin(), setup.reductions.end());
+  tints.insert(options_i::m_default_tint);
+  std::set<std::string> read_options;
+  for (const auto& tint_groups : all.options->get_collection_of_options())
+  {
+    if (tints.count(tint_groups.first) == 0) { continue; }
+    for (const auto& group : tint_groups.second)
+    {
+      for (const auto& option : group.m_options) { read_options.insert(option->m_name); }
+    }
+  }
+
+  option_tokens_writer writer(setup.args);
+  for (const auto& option : all.options->get_all_options())
+  {
+    if (read_options.count(option->m_name) != 0 && all.options->was_supplied(option->m_name))
+    { option->accept(writer); }
+  }
+
+  for (const auto& token : all.options->get_positional_tokens()) { setup.args.push_back(token); }
+  return setup;
+}
+
+std::string serialize_resolved_setup(const resolved_setup& setup)
+{
+  std::ostringstream output;
+  output << SERIALIZED_HEADER << '\n';
+  write_lines(output, setup.reductions);
+  write_lines(output, setup.args);
+  return output.str();
+}
+
+resolved_setup deserialize_resolved_setup(const std::string& blob)
+{
+  std::istringstream input(blob);
+  std::string header;
+  if (!std::getline(input, header) || header != SERIALIZED_HEADER)
+  { THROW("not a resolved setup, expected header '" << SERIALIZED_HEADER << "'"); }
+
+  resolved_setup setup;
+  setup.reductions = read_lines(input);
+  setup.args = read_lines(input);
+  return setup;
+}
+}  // namespace VW
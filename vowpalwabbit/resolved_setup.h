@@ -0,0 +1,34 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "vw_fwd.h"
+
+#include <string>
+#include <vector>
+
+namespace VW
+{
+// The outcome of setting up a workspace: the options it was given and the reductions they enabled.
+//
+// Setting up a workspace from the command line calls the setup function of every reduction, each defining and parsing
+// its options, only to find out which of them are enabled. A workspace set up from a resolved setup only calls the
+// setup functions of the reductions that were enabled, with a command line trimmed to the options they use. Save one
+// with serialize_resolved_setup and pass it to VW::initialize to start many workspaces of the same configuration
+// quickly.
+struct resolved_setup
+{
+  // Command line tokens of every supplied option read by the workspace, positional arguments last.
+  std::vector<std::string> args;
+  // Names of the enabled setup functions, base first.
+  std::vector<std::string> reductions;
+};
+
+resolved_setup resolve_setup(VW::workspace& all);
+
+std::string serialize_resolved_setup(const resolved_setup& setup);
+// Throws if blob was not made by serialize_resolved_setup.
+resolved_setup deserialize_resolved_setup(const std::string& blob);
+}  // namespace VW
@@ -0,0 +1,95 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include "constant.h"
+#include "feature_group.h"
+#include "v_array.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace VW
+{
+struct example;
+
+// Attached by shared_feature_merger to the action examples of a multi_ex while it is predicted on. The shared
+// example's namespaces are still merged into every action, but the part of the score which only involves them, its
+// linear terms and the interactions made up of shared namespaces only, is the same for every action. gd computes that
+// part once per weight offset and adds it to the score of the remaining terms of each action.
+//
+// Only namespaces which the actions do not use themselves are treated as shared, so every feature is scored exactly
+// once. Reductions below the merger may still add to or rewrite the merged namespaces of an action, so gd compares
+// them with those of the shared example and scores the action in full when they differ.
+//
+// Interactions are matched by their terms rather than their address: generate_interactions rebuilds its interactions
+// in place whenever an action brings a namespace it has not seen before.
+struct shared_feature_cache
+{
+  using interactions_t = std::vector<std::vector<namespace_index>>;
+
+  struct split_interactions
+  {
+    interactions_t source;
+    interactions_t shared_only;  // every namespace is shared, scored once on the shared example
+    interactions_t remaining;    // scored on each action
+  };
+
+  struct shared_score
+  {
+    uint64_t ft_offset;
+    size_t split;  // index into splits
+    float score;
+    size_t num_interacted_features;
+  };
+
+  example* shared = nullptr;
+  std::array<bool, NUM_NAMESPACES> is_shared_namespace;
+
+  // Only a handful of distinct offsets and interaction sets occur per multi_ex, so linear scans are fastest.
+  std::vector<split_interactions> splits;
+  std::vector<shared_score> scores;
+
+  // Scratch space holding the namespaces gd scores for one example.
+  v_array<namespace_index> indices;
+
+  void reset(example* shared_example)
+  {
+    shared = shared_example;
+    is_shared_namespace.fill(false);
+    splits.clear();
+    scores.clear();
+  }
+
+  // Returns the index of the split of the given interactions into splits.
+  size_t split(const interactions_t& interactions)
+  {
+    for (size_t i = 0; i < splits.size(); i++)
+    {
+      if (splits[i].source == interactions) { return i; }
+    }
+
+    splits.push_back({interactions, {}, {}});
+    auto& s = splits.back();
+    for (const auto& inter : interactions)
+    {
+      bool shared_only = true;
+      for (auto ns : inter) { shared_only = shared_only && is_shared_namespace[ns]; }
+      (shared_only ? s.shared_only : s.remaining).push_back(inter);
+    }
+    return splits.size() - 1;
+  }
+
+  shared_score* find_score(uint64_t ft_offset, size_t split)
+  {
+    for (auto& s : scores)
+    {
+      if (s.ft_offset == ft_offset && s.split == split) { return &s; }
+    }
+    return nullptr;
+  }
+};
+}  // namespace VW
@@ -0,0 +1,63 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+// Sockets of the servers workers connect to over TCP, the spanning tree and the parameter server.
+#pragma once
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+
+#  include <WS2tcpip.h>
+#  include <WinSock2.h>
+#  include <Windows.h>
+#  include <io.h>
+
+#  define CLOSESOCK closesocket
+#  define inet_ntop InetNtopA
+
+typedef int socklen_t;
+typedef SOCKET socket_t;
+#else
+#  include <arpa/inet.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <strings.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+
+#  define CLOSESOCK close
+
+typedef int socket_t;
+#endif
+
+namespace VW
+{
+namespace details
+{
+// WSAStartup and WSACleanup on Windows, nothing elsewhere. Every startup must be matched by a cleanup.
+void socket_library_startup();
+void socket_library_cleanup();
+
+bool is_valid_socket(socket_t s);
+
+// Flags for send(). Writing to a socket whose peer went away raises SIGPIPE by default, which kills the whole server
+// over one lost client. With these the send fails with EPIPE instead. macOS has no such flag, there sockets must have
+// had disable_sigpipe() called on them.
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+// Sets SO_NOSIGPIPE where the platform has it, see SEND_FLAGS.
+void disable_sigpipe(socket_t s);
+
+// Listens for TCP connections on port of every IPv4 interface, or on a free port if port is 0. bound_port is set to
+// the port listened on. Throws if the socket cannot be set up.
+socket_t open_listening_socket(unsigned short port, unsigned short& bound_port);
+}  // namespace details
+}  // namespace VW
@@ -4,23 +4,13 @@
 
 #pragma once
 
-#ifdef _WIN32
-#  ifndef NOMINMAX
-#    define NOMINMAX
-#  endif
-
-#  include <WS2tcpip.h>
-#  include <WinSock2.h>
-#  include <Windows.h>
-#  include <io.h>
+#include "vw/spanning_tree/socket_utils.h"
 
-#  define CLOSESOCK closesocket
-#  define inet_ntop InetNtopA
+#include <cstddef>
 
+#ifdef _WIN32
 typedef unsigned int uint32_t;
 typedef unsigned short uint16_t;
-typedef int socklen_t;
-typedef SOCKET socket_t;
 
 namespace std
 {
@@ -29,23 +19,25 @@ template <typename T>
 class future;
 }  // namespace std
 #else
-#  include <arpa/inet.h>
-#  include <netdb.h>
-#  include <netinet/in.h>
-#  include <netinet/tcp.h>
-#  include <strings.h>
-#  include <sys/socket.h>
-#  include <unistd.h>
-
-#  define CLOSESOCK close
-
-typedef int socket_t;
-
 #  include <future>
 #endif
 
 namespace VW
 {
+// Aggregate counters describing the jobs the spanning tree has wired up so far.
+struct SpanningTreeMetrics
+{
+  size_t jobs_completed;
+  size_t jobs_timed_out;
+  size_t jobs_failed;
+  size_t jobs_in_progress;
+  // Time from the first node of a job connecting until every node was sent its place in the tree.
+  double total_setup_seconds;
+  double max_setup_seconds;
+};
+
+struct spanning_tree_state;
+
 class SpanningTree
 {
 private:
@@ -58,9 +50,14 @@ private:
   std::future<void>* m_future;
 
   bool m_quiet;
+  // Jobs (and connections which never complete the handshake) are dropped after this many seconds. 0 waits forever.
+  size_t m_job_timeout;
+
+  // Kept behind a pointer for the same reason as m_future.
+  spanning_tree_state* m_state;
 
 public:
-  SpanningTree(short unsigned int port = 26543, bool quiet = false);
+  SpanningTree(short unsigned int port = 26543, bool quiet = false, size_t job_timeout_seconds = 0);
   ~SpanningTree();
 
   short unsigned int BoundPort();
@@ -68,5 +65,7 @@ public:
   void Start();
   void Run();
   void Stop();
+
+  SpanningTreeMetrics GetMetrics();
 };
 }  // namespace VW
@@ -0,0 +1,86 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/spanning_tree/socket_utils.h"
+
+#include "vw/common/vw_exception.h"
+
+#include <cstring>
+
+namespace VW
+{
+namespace details
+{
+void socket_library_startup()
+{
+#ifdef _WIN32
+  WSAData wsaData;
+  int lastError = WSAStartup(MAKEWORD(2, 2), &wsaData);
+  if (lastError != 0) THROWERRNO("WSAStartup() returned error:" << lastError);
+#endif
+}
+
+void socket_library_cleanup()
+{
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+bool is_valid_socket(socket_t s)
+{
+#ifdef _WIN32
+  return s != INVALID_SOCKET;
+#else
+  return s >= 0;
+#endif
+}
+
+void disable_sigpipe(socket_t s)
+{
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<char*>(&on), sizeof(on));
+#else
+  (void)s;
+#endif
+}
+
+socket_t open_listening_socket(unsigned short port, unsigned short& bound_port)
+{
+  // TODO: This only supports IPV4 (AF_INET) addresses. To support IPV6 (AF_INET6), a number of changes needs
+  // to be made here.
+  char addr_buf[INET_ADDRSTRLEN];
+
+  socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+  if (!is_valid_socket(sock)) THROWERRNO("socket: ");
+
+  int on = 1;
+  if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&on), sizeof(on)) < 0)
+    THROWERRNO("setsockopt SO_REUSEADDR: ");
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  address.sin_port = htons(port);
+  if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    THROWERRNO("bind failed for " << inet_ntop(AF_INET, &address.sin_addr, addr_buf, INET_ADDRSTRLEN) << ':' << port);
+
+  sockaddr_in bound_addr;
+  memset(&bound_addr, 0, sizeof(bound_addr));
+  socklen_t len = sizeof(bound_addr);
+  if (::getsockname(sock, reinterpret_cast<sockaddr*>(&bound_addr), &len) < 0)
+    THROWERRNO("getsockname: " << inet_ntop(AF_INET, &bound_addr.sin_addr, addr_buf, INET_ADDRSTRLEN));
+
+  // which port did we bind too (if port is 0 this will give us the actual port)
+  bound_port = ntohs(bound_addr.sin_port);
+
+  // Listen right away so that clients can connect as soon as this returns, even before connections are accepted.
+  if (listen(sock, 1024) < 0) THROWERRNO("listen: ");
+  return sock;
+}
+}  // namespace details
+}  // namespace VW
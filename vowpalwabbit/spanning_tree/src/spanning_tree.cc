@@ -11,29 +11,69 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#  define poll WSAPoll
+#else
+#  include <fcntl.h>
+#  include <poll.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <future>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // TODO: spanning tree exists outside the normal VW source (it should live in cluster/).
 //       If we use io/logger.h here, we need to link it to the cluster library
 
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+// How long a single poll waits before timeouts and the stop flag are checked again.
+constexpr int POLL_INTERVAL_MS = 100;
+
 struct client
 {
   uint32_t client_ip;
   socket_t socket;
 };
 
-struct partial
+// A connection which has not yet sent its nonce, node count and node id.
+struct pending_connection
 {
-  client* nodes;
+  socket_t socket;
+  uint32_t client_ip;
+  std::string peer;
+  char handshake[3 * sizeof(size_t)];
+  size_t received;
+  clock_type::time_point accepted;
+};
+
+// All nodes of one job share a nonce. The job waits until every node connected, then every node reports the port it
+// listens on and is finally sent the address of its parent.
+struct job
+{
+  size_t total;
   size_t filled;
+  std::vector<client> nodes;
+  clock_type::time_point started;
+
+  bool building;
+  std::vector<int> parent;
+  std::vector<uint16_t> client_ports;
+  std::vector<size_t> port_bytes;
+  size_t ports_received;
 };
 
-static int socket_sort(const void* s1, const void* s2)
+int socket_sort(const void* s1, const void* s2)
 {
   client* socket1 = (client*)s1;
   client* socket2 = (client*)s2;
@@ -44,6 +84,51 @@ static int socket_sort(const void* s1, const void* s2)
   }
 }
 
+void set_nonblocking(socket_t s)
+{
+#ifdef _WIN32
+  u_long mode = 1;
+  if (ioctlsocket(s, FIONBIO, &mode) != 0) THROWERRNO("ioctlsocket FIONBIO: ");
+#else
+  int flags = fcntl(s, F_GETFL, 0);
+  if (flags < 0 || fcntl(s, F_SETFL, flags | O_NONBLOCK) < 0) THROWERRNO("fcntl O_NONBLOCK: ");
+#endif
+}
+
+// Returns the number of bytes read, 0 if nothing is available right now and -1 if the peer went away.
+int recv_some(socket_t s, char* buf, size_t count)
+{
+  auto received = recv(s, buf, static_cast<int>(count), 0);
+  if (received > 0) { return static_cast<int>(received); }
+  if (received == 0) { return -1; }
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+#else
+  return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+#endif
+}
+
+// Only a handful of bytes are ever written to a freshly connected socket so this never has to wait for buffer space. A
+// node that already went away fails here instead of raising SIGPIPE.
+bool try_send(const socket_t fd, const void* buf, const int count)
+{
+  return send(fd, static_cast<const char*>(buf), count, VW::details::SEND_FLAGS) == count;
+}
+
+void close_job(job& j)
+{
+  for (auto& node : j.nodes)
+  {
+    if (node.client_ip != static_cast<uint32_t>(-1)) { CLOSESOCK(node.socket); }
+  }
+}
+
+double seconds_since(clock_type::time_point start, clock_type::time_point now)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double>>(now - start).count();
+}
+}  // namespace
+
 int build_tree(int* parent, uint16_t* kid_count, size_t source_count, int offset)
 {
   if (source_count == 1)
@@ -77,63 +162,44 @@ int build_tree(int* parent, uint16_t* kid_count, size_t source_count, int offset
   return oroot;
 }
 
-void fail_send(const socket_t fd, const void* buf, const int count)
-{
-  if (send(fd, (char*)buf, count, 0) == -1) THROWERRNO("send: ");
-}
-
 namespace VW
 {
-SpanningTree::SpanningTree(uint16_t port, bool quiet) : m_stop(false), m_port(port), m_future(nullptr), m_quiet(quiet)
+struct spanning_tree_state
 {
-#ifdef _WIN32
-  WSAData wsaData;
-  int lastError = WSAStartup(MAKEWORD(2, 2), &wsaData);
-  if (lastError != 0) THROWERRNO("WSAStartup() returned error:" << lastError);
-#endif
-
-  // TODO: This only supports IPV4 (AF_INET) addresses. To support IPV6 (AF_INET6), a number of changes needs
-  // to be made here.
-  char addr_buf[INET_ADDRSTRLEN];
-
-  sock = socket(PF_INET, SOCK_STREAM, 0);
-#ifdef _WIN32
-  if (sock == INVALID_SOCKET)
-#else
-  if (sock < 0)
-#endif
-    THROWERRNO("socket: ");
-
-  int on = 1;
-  if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char*>(&on), sizeof(on)) < 0)
-    THROWERRNO("setsockopt SO_REUSEADDR: ");
-
-  sockaddr_in address;
-  address.sin_family = AF_INET;
-  address.sin_addr.s_addr = htonl(INADDR_ANY);
-
-  address.sin_port = htons(port);
-  if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
-    THROWERRNO("bind failed for " << inet_ntop(AF_INET, &address.sin_addr, addr_buf, INET_ADDRSTRLEN));
+  std::mutex mutex;
+  SpanningTreeMetrics metrics;
+};
 
-  sockaddr_in bound_addr;
-  memset(&bound_addr, 0, sizeof(bound_addr));
-  socklen_t len = sizeof(bound_addr);
-  if (::getsockname(sock, reinterpret_cast<sockaddr*>(&bound_addr), &len) < 0)
-    THROWERRNO("getsockname: " << inet_ntop(AF_INET, &bound_addr.sin_addr, addr_buf, INET_ADDRSTRLEN));
+SpanningTree::SpanningTree(uint16_t port, bool quiet, size_t job_timeout_seconds)
+    : m_stop(false)
+    , m_port(port)
+    , m_future(nullptr)
+    , m_quiet(quiet)
+    , m_job_timeout(job_timeout_seconds)
+    , m_state(new spanning_tree_state())
+{
+  memset(&m_state->metrics, 0, sizeof(m_state->metrics));
 
-  // which port did we bind too (if m_port is 0 this will give us the actual port)
-  m_port = ntohs(bound_addr.sin_port);
+  VW::details::socket_library_startup();
+  // Listens right away so that clients can connect as soon as the constructor returns, even if Run() has not started.
+  sock = VW::details::open_listening_socket(port, m_port);
 }
 
 SpanningTree::~SpanningTree()
 {
   Stop();
   delete m_future;
+  delete m_state;
 }
 
 short unsigned int SpanningTree::BoundPort() { return m_port; }
 
+SpanningTreeMetrics SpanningTree::GetMetrics()
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->metrics;
+}
+
 void SpanningTree::Start()
 {
   // launch async
@@ -152,171 +218,306 @@ void SpanningTree::Stop()
   CLOSESOCK(sock);
 
   // wait for run to stop
-  if (m_future != nullptr) { m_future->get(); }
+  if (m_future != nullptr && m_future->valid()) { m_future->get(); }
 }
 
 void SpanningTree::Run()
 {
-  std::map<size_t, partial> partial_nodesets;
-  while (!m_stop)
-  {
-    if (listen(sock, 1024) < 0) THROWERRNO("listen: ");
-
-    sockaddr_in client_address;
-    socklen_t size = sizeof(client_address);
-    socket_t f = accept(sock, reinterpret_cast<sockaddr*>(&client_address), &size);
-#ifdef _WIN32
-    if (f == INVALID_SOCKET)
-    {
-#else
-    if (f < 0)
+  std::vector<pending_connection> pending;
+  std::map<size_t, job> jobs;
+  std::vector<pollfd> fds;
+  std::unordered_map<socket_t, short> ready;
+
+  auto finish_job = [&](std::map<size_t, job>::iterator it, bool completed, bool timed_out) {
+    const auto now = clock_type::now();
+    const double setup_seconds = seconds_since(it->second.started, now);
     {
-#endif
-      break;
+      std::lock_guard<std::mutex> lock(m_state->mutex);
+      auto& metrics = m_state->metrics;
+      if (completed)
+      {
+        metrics.jobs_completed++;
+        metrics.total_setup_seconds += setup_seconds;
+        metrics.max_setup_seconds = std::max(metrics.max_setup_seconds, setup_seconds);
+      }
+      else if (timed_out) { metrics.jobs_timed_out++; }
+      else
+      {
+        metrics.jobs_failed++;
+      }
     }
-
-    char dotted_quad[INET_ADDRSTRLEN];
-    if (nullptr == inet_ntop(AF_INET, &(client_address.sin_addr), dotted_quad, INET_ADDRSTRLEN))
-      THROWERRNO("inet_ntop: ");
-
-    char hostname[NI_MAXHOST];
-    char servInfo[NI_MAXSERV];
-    if (getnameinfo(reinterpret_cast<sockaddr*>(&client_address), sizeof(sockaddr), hostname, NI_MAXHOST, servInfo,
-            NI_MAXSERV, 0))
-      THROWERRNO("getnameinfo: ");
-
     if (!m_quiet)
     {
-      std::cerr << "inbound connection from " << dotted_quad << "(" << hostname << ':' << ntohs(m_port)
-                << ") serv=" << servInfo << std::endl;
+      if (completed)
+      {
+        std::cerr << "nonce " << it->first << ": spanning tree of " << it->second.total << " nodes set up in "
+                  << setup_seconds * 1000. << " ms" << std::endl;
+      }
+      else
+      {
+        std::cerr << "nonce " << it->first << (timed_out ? ": timed out" : ": failed") << " after " << setup_seconds
+                  << " s with " << it->second.filled << " of " << it->second.total << " nodes connected"
+                  << std::endl;
+      }
+    }
+    close_job(it->second);
+    return jobs.erase(it);
+  };
+
+  // Every node is connected, tell each one how many children it has and wait for the ports they listen on.
+  auto start_building = [&](std::map<size_t, job>::iterator it) {
+    job& j = it->second;
+    qsort(j.nodes.data(), j.total, sizeof(client), socket_sort);
+
+    j.parent.assign(j.total, 0);
+    std::vector<uint16_t> kid_count(j.total, 0);
+    int root = build_tree(j.parent.data(), kid_count.data(), j.total, 0);
+    j.parent[root] = -1;
+
+    j.building = true;
+    j.client_ports.assign(j.total, 0);
+    j.port_bytes.assign(j.total, 0);
+    j.ports_received = 0;
+
+    for (size_t i = 0; i < j.total; i++)
+    {
+      if (!try_send(j.nodes[i].socket, &kid_count[i], sizeof(kid_count[i])))
+      {
+        finish_job(it, false, false);
+        return;
+      }
     }
+  };
 
-    size_t nonce = 0;
-    if (recv(f, reinterpret_cast<char*>(&nonce), sizeof(nonce), 0) != sizeof(nonce))
-    { THROW(dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): nonce read failed, exiting"); }
-    else
+  // Every node reported its port, send each one the address of its parent.
+  auto connect_tree = [&](std::map<size_t, job>::iterator it) {
+    job& j = it->second;
+    bool ok = true;
+    for (size_t i = 0; i < j.total && ok; i++)
     {
-      if (!m_quiet)
-      { std::cerr << dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): nonce=" << nonce << std::endl; }
+      if (j.parent[i] >= 0)
+      {
+        ok = try_send(j.nodes[i].socket, &j.nodes[j.parent[i]].client_ip, sizeof(j.nodes[j.parent[i]].client_ip)) &&
+            try_send(j.nodes[i].socket, &j.client_ports[j.parent[i]], sizeof(j.client_ports[j.parent[i]]));
+      }
+      else
+      {
+        int bogus = -1;
+        uint32_t bogus2 = static_cast<uint32_t>(-1);
+        ok = try_send(j.nodes[i].socket, &bogus2, sizeof(bogus2)) && try_send(j.nodes[i].socket, &bogus, sizeof(bogus));
+      }
     }
-    size_t total = 0;
-    if (recv(f, reinterpret_cast<char*>(&total), sizeof(total), 0) != sizeof(total))
-    { THROW(dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): total node count read failed, exiting"); }
-    else
+    return finish_job(it, ok, false);
+  };
+
+  auto handshake_done = [&](pending_connection& c) {
+    size_t nonce, total, id;
+    memcpy(&nonce, c.handshake, sizeof(nonce));
+    memcpy(&total, c.handshake + sizeof(nonce), sizeof(total));
+    memcpy(&id, c.handshake + sizeof(nonce) + sizeof(total), sizeof(id));
+    if (!m_quiet)
+    { std::cerr << c.peer << ": nonce=" << nonce << " total=" << total << " node id=" << id << std::endl; }
+
+    auto it = jobs.find(nonce);
+    int ok = id < total;
+    if (!ok && !m_quiet) { std::cout << c.peer << ": invalid id=" << id << " >=  " << total << std::endl; }
+    if (ok && it != jobs.end() && it->second.total != total)
     {
       if (!m_quiet)
-      { std::cerr << dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): total=" << total << std::endl; }
+      { std::cout << c.peer << ": total=" << total << " does not match " << it->second.total << std::endl; }
+      ok = false;
     }
-    size_t id = 0;
-    if (recv(f, reinterpret_cast<char*>(&id), sizeof(id), 0) != sizeof(id))
-    { THROW(dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): node id read failed, exiting"); }
-    else
+    if (ok && it != jobs.end() &&
+        (it->second.building || it->second.nodes[id].client_ip != static_cast<uint32_t>(-1)))
+    { ok = false; }
+
+    // The job is only created once the node got its ack, a node that left before that must not leave an empty job.
+    if (!try_send(c.socket, &ok, sizeof(ok)) || !ok)
     {
-      if (!m_quiet)
-      { std::cerr << dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): node id=" << id << std::endl; }
+      CLOSESOCK(c.socket);
+      return;
     }
 
-    int ok = true;
-    if (id >= total)
+    if (it == jobs.end())
     {
-      if (!m_quiet)
-      {
-        std::cout << dotted_quad << "(" << hostname << ':' << ntohs(m_port) << "): invalid id=" << id
-                  << " >=  " << total << std::endl;
-      }
-      ok = false;
+      job j;
+      j.total = total;
+      j.filled = 0;
+      j.nodes.resize(total);
+      for (auto& node : j.nodes) { node.client_ip = static_cast<uint32_t>(-1); }
+      j.started = c.accepted;
+      j.building = false;
+      j.ports_received = 0;
+      it = jobs.emplace(nonce, std::move(j)).first;
     }
-    partial partial_nodeset;
 
-    if (partial_nodesets.find(nonce) == partial_nodesets.end())
+    job& j = it->second;
+    j.nodes[id].client_ip = c.client_ip;
+    j.nodes[id].socket = c.socket;
+    j.filled++;
+    j.started = std::min(j.started, c.accepted);
+    if (j.filled == j.total) { start_building(it); }
+    else if (!m_quiet)
     {
-      partial_nodeset.nodes = static_cast<client*>(calloc(total, sizeof(client)));
-      for (size_t i = 0; i < total; i++) { partial_nodeset.nodes[i].client_ip = static_cast<uint32_t>(-1); }
-      partial_nodeset.filled = 0;
+      std::cout << "nonce " << nonce << " still waiting for " << (j.total - j.filled) << " nodes out of " << j.total
+                << std::endl;
     }
-    else
+  };
+
+  while (!m_stop)
+  {
+    fds.clear();
+    fds.push_back({sock, POLLIN, 0});
+    for (const auto& c : pending) { fds.push_back({c.socket, POLLIN, 0}); }
+    for (const auto& kv : jobs)
     {
-      partial_nodeset = partial_nodesets[nonce];
-      partial_nodesets.erase(nonce);
+      if (!kv.second.building) { continue; }
+      for (size_t i = 0; i < kv.second.total; i++)
+      {
+        if (kv.second.port_bytes[i] < sizeof(uint16_t)) { fds.push_back({kv.second.nodes[i].socket, POLLIN, 0}); }
+      }
     }
 
-    if (ok && partial_nodeset.nodes[id].client_ip != static_cast<uint32_t>(-1)) { ok = false; }
-    fail_send(f, &ok, sizeof(ok));
+    int num_ready = poll(fds.data(), static_cast<unsigned long>(fds.size()), POLL_INTERVAL_MS);
+    if (m_stop) { break; }
+    if (num_ready < 0)
+    {
+#ifndef _WIN32
+      if (errno == EINTR) { continue; }
+#endif
+      THROWERRNO("poll: ");
+    }
 
-    if (ok)
+    ready.clear();
+    for (size_t i = 1; i < fds.size(); i++)
     {
-      partial_nodeset.nodes[id].client_ip = client_address.sin_addr.s_addr;
-      partial_nodeset.nodes[id].socket = f;
-      partial_nodeset.filled++;
+      if (fds[i].revents != 0) { ready[fds[i].fd] = fds[i].revents; }
     }
-    if (partial_nodeset.filled != total)  // Need to wait for more connections
+
+    // Connections still sending their handshake.
+    for (size_t i = 0; i < pending.size();)
     {
-      partial_nodesets[nonce] = partial_nodeset;
-      for (size_t i = 0; i < total; i++)
+      auto& c = pending[i];
+      auto found = ready.find(c.socket);
+      if (found == ready.end())
+      {
+        i++;
+        continue;
+      }
+      ready.erase(found);
+
+      int n = recv_some(c.socket, c.handshake + c.received, sizeof(c.handshake) - c.received);
+      if (n > 0) { c.received += n; }
+      if (n < 0 || c.received == sizeof(c.handshake))
       {
-        if (partial_nodeset.nodes[i].client_ip == static_cast<uint32_t>(-1))
+        if (n < 0)
         {
-          if (!m_quiet)
-          {
-            std::cout << "nonce " << nonce << " still waiting for " << (total - partial_nodeset.filled)
-                      << " nodes out of " << total << " for example node " << i << std::endl;
-          }
-          break;
+          if (!m_quiet) { std::cerr << c.peer << ": handshake read failed, dropping connection" << std::endl; }
+          CLOSESOCK(c.socket);
         }
+        else
+        {
+          handshake_done(c);
+        }
+        pending[i] = pending.back();
+        pending.pop_back();
+      }
+      else
+      {
+        i++;
       }
     }
-    else
-    {
-      // Time to make the spanning tree
-      qsort(partial_nodeset.nodes, total, sizeof(client), socket_sort);
-
-      int* parent = static_cast<int*>(calloc(total, sizeof(int)));
-      uint16_t* kid_count = static_cast<uint16_t*>(calloc(total, sizeof(uint16_t)));
-
-      int root = build_tree(parent, kid_count, total, 0);
-      parent[root] = -1;
-
-      for (size_t i = 0; i < total; i++)
-      { fail_send(partial_nodeset.nodes[i].socket, &kid_count[i], sizeof(kid_count[i])); }
 
-      uint16_t* client_ports = static_cast<uint16_t*>(calloc(total, sizeof(uint16_t)));
-
-      for (size_t i = 0; i < total; i++)
+    // Jobs waiting on their nodes to report the port they listen on.
+    for (auto it = jobs.begin(); it != jobs.end();)
+    {
+      job& j = it->second;
+      bool failed = false;
+      for (size_t i = 0; j.building && i < j.total && !failed; i++)
       {
-        int done = 0;
-        if (recv(partial_nodeset.nodes[i].socket, reinterpret_cast<char*>(&(client_ports[i])), sizeof(client_ports[i]),
-                0) < static_cast<int>(sizeof(client_ports[i])))
+        if (j.port_bytes[i] == sizeof(uint16_t) || ready.find(j.nodes[i].socket) == ready.end()) { continue; }
+        int n = recv_some(j.nodes[i].socket, reinterpret_cast<char*>(&j.client_ports[i]) + j.port_bytes[i],
+            sizeof(uint16_t) - j.port_bytes[i]);
+        if (n < 0)
+        {
+          if (!m_quiet) { std::cerr << " Port read failed for node " << i << std::endl; }
+          failed = true;
+        }
+        else
         {
-          if (!m_quiet) { std::cerr << " Port read failed for node " << i << " read " << done << std::endl; }
+          j.port_bytes[i] += n;
+          if (j.port_bytes[i] == sizeof(uint16_t)) { j.ports_received++; }
         }
-      }  // all clients have bound to their ports.
+      }
 
-      for (size_t i = 0; i < total; i++)
+      if (failed) { it = finish_job(it, false, false); }
+      else if (j.building && j.ports_received == j.total) { it = connect_tree(it); }
+      else
       {
-        if (parent[i] >= 0)
+        ++it;
+      }
+    }
+
+    if (m_job_timeout > 0)
+    {
+      const auto now = clock_type::now();
+      const auto timeout = std::chrono::seconds(m_job_timeout);
+      for (size_t i = 0; i < pending.size();)
+      {
+        if (now - pending[i].accepted > timeout)
         {
-          fail_send(partial_nodeset.nodes[i].socket, &partial_nodeset.nodes[parent[i]].client_ip,
-              sizeof(partial_nodeset.nodes[parent[i]].client_ip));
-          fail_send(partial_nodeset.nodes[i].socket, &client_ports[parent[i]], sizeof(client_ports[parent[i]]));
+          if (!m_quiet) { std::cerr << pending[i].peer << ": handshake timed out" << std::endl; }
+          CLOSESOCK(pending[i].socket);
+          pending[i] = pending.back();
+          pending.pop_back();
         }
         else
         {
-          int bogus = -1;
-          uint32_t bogus2 = static_cast<uint32_t>(-1);
-          fail_send(partial_nodeset.nodes[i].socket, &bogus2, sizeof(bogus2));
-          fail_send(partial_nodeset.nodes[i].socket, &bogus, sizeof(bogus));
+          i++;
         }
-        CLOSESOCK(partial_nodeset.nodes[i].socket);
       }
-      free(client_ports);
-      free(partial_nodeset.nodes);
-      free(parent);
-      free(kid_count);
+      for (auto it = jobs.begin(); it != jobs.end();)
+      {
+        if (now - it->second.started > timeout) { it = finish_job(it, false, true); }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_state->mutex);
+      m_state->metrics.jobs_in_progress = jobs.size();
     }
+
+    if (fds[0].revents == 0) { continue; }
+    if (!(fds[0].revents & POLLIN)) { break; }
+
+    sockaddr_in client_address;
+    socklen_t size = sizeof(client_address);
+    socket_t f = accept(sock, reinterpret_cast<sockaddr*>(&client_address), &size);
+    if (!VW::details::is_valid_socket(f)) { break; }
+    set_nonblocking(f);
+    VW::details::disable_sigpipe(f);
+
+    char dotted_quad[INET_ADDRSTRLEN];
+    if (nullptr == inet_ntop(AF_INET, &(client_address.sin_addr), dotted_quad, INET_ADDRSTRLEN))
+      THROWERRNO("inet_ntop: ");
+
+    pending_connection c;
+    c.socket = f;
+    c.client_ip = client_address.sin_addr.s_addr;
+    c.peer = std::string(dotted_quad) + ":" + std::to_string(ntohs(client_address.sin_port));
+    c.received = 0;
+    c.accepted = clock_type::now();
+    if (!m_quiet) { std::cerr << "inbound connection from " << c.peer << std::endl; }
+    pending.push_back(std::move(c));
   }
 
-#ifdef _WIN32
-  WSACleanup();
-#endif
+  for (auto& c : pending) { CLOSESOCK(c.socket); }
+  for (auto& kv : jobs) { close_job(kv.second); }
+
+  VW::details::socket_library_cleanup();
 }
 }  // namespace VW
@@ -0,0 +1,175 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "vw/spanning_tree/spanning_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+socket_t connect_node(uint16_t port, size_t nonce, size_t total, size_t id, int& ok)
+{
+  socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+  sockaddr_in far_end;
+  memset(&far_end, 0, sizeof(far_end));
+  far_end.sin_family = AF_INET;
+  far_end.sin_port = htons(port);
+  far_end.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&far_end), sizeof(far_end)), 0);
+
+  EXPECT_EQ(send(sock, reinterpret_cast<const char*>(&nonce), sizeof(nonce), 0), sizeof(nonce));
+  EXPECT_EQ(send(sock, reinterpret_cast<const char*>(&total), sizeof(total), 0), sizeof(total));
+  EXPECT_EQ(send(sock, reinterpret_cast<const char*>(&id), sizeof(id), 0), sizeof(id));
+  ok = 0;
+  EXPECT_EQ(recv(sock, reinterpret_cast<char*>(&ok), sizeof(ok), MSG_WAITALL), sizeof(ok));
+  return sock;
+}
+
+// Runs one node through the whole setup, returns its kid count.
+uint16_t join_tree(uint16_t port, size_t nonce, size_t total, size_t id)
+{
+  int ok = 0;
+  auto sock = connect_node(port, nonce, total, id, ok);
+  EXPECT_EQ(ok, 1);
+
+  uint16_t kid_count = 0;
+  EXPECT_EQ(recv(sock, reinterpret_cast<char*>(&kid_count), sizeof(kid_count), MSG_WAITALL), sizeof(kid_count));
+  uint16_t netport = htons(static_cast<uint16_t>(10000 + id));
+  EXPECT_EQ(send(sock, reinterpret_cast<const char*>(&netport), sizeof(netport), 0), sizeof(netport));
+  uint32_t parent_ip = 0;
+  uint16_t parent_port = 0;
+  EXPECT_EQ(recv(sock, reinterpret_cast<char*>(&parent_ip), sizeof(parent_ip), MSG_WAITALL), sizeof(parent_ip));
+  EXPECT_EQ(recv(sock, reinterpret_cast<char*>(&parent_port), sizeof(parent_port), MSG_WAITALL), sizeof(parent_port));
+  CLOSESOCK(sock);
+  return kid_count;
+}
+
+// The last node of a job may see its reply before the coordinator gets to update the metrics.
+VW::SpanningTreeMetrics wait_for_jobs(VW::SpanningTree& tree, size_t finished_jobs)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  auto metrics = tree.GetMetrics();
+  while (metrics.jobs_completed + metrics.jobs_timed_out + metrics.jobs_failed < finished_jobs &&
+      std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    metrics = tree.GetMetrics();
+  }
+  return metrics;
+}
+}  // namespace
+
+TEST(spanning_tree_tests, many_concurrent_jobs)
+{
+  VW::SpanningTree tree(0, true);
+  tree.Start();
+
+  constexpr size_t num_jobs = 16;
+  constexpr size_t nodes_per_job = 5;
+  std::vector<std::thread> nodes;
+  std::vector<uint16_t> kid_counts(num_jobs * nodes_per_job, 0);
+  // Interleave the nodes of all jobs, no job can complete before the last round of connections.
+  for (size_t id = 0; id < nodes_per_job; id++)
+  {
+    for (size_t job = 0; job < num_jobs; job++)
+    {
+      nodes.emplace_back([&tree, &kid_counts, job, id]() {
+        kid_counts[job * nodes_per_job + id] = join_tree(tree.BoundPort(), 1000 + job, nodes_per_job, id);
+      });
+    }
+  }
+  for (auto& node : nodes) { node.join(); }
+
+  // Every tree over n nodes has n - 1 edges.
+  for (size_t job = 0; job < num_jobs; job++)
+  {
+    size_t edges = 0;
+    for (size_t id = 0; id < nodes_per_job; id++) { edges += kid_counts[job * nodes_per_job + id]; }
+    EXPECT_EQ(edges, nodes_per_job - 1);
+  }
+
+  auto metrics = wait_for_jobs(tree, num_jobs);
+  EXPECT_EQ(metrics.jobs_completed, num_jobs);
+  EXPECT_EQ(metrics.jobs_timed_out, 0);
+  EXPECT_EQ(metrics.jobs_failed, 0);
+  EXPECT_LE(metrics.max_setup_seconds, metrics.total_setup_seconds);
+  EXPECT_LE(metrics.total_setup_seconds, metrics.max_setup_seconds * num_jobs);
+  tree.Stop();
+}
+
+TEST(spanning_tree_tests, duplicate_node_id_is_rejected)
+{
+  VW::SpanningTree tree(0, true);
+  tree.Start();
+
+  int ok = 0;
+  auto first = connect_node(tree.BoundPort(), 7, 2, 0, ok);
+  EXPECT_EQ(ok, 1);
+  auto second = connect_node(tree.BoundPort(), 7, 2, 0, ok);
+  EXPECT_EQ(ok, 0);
+  auto mismatched = connect_node(tree.BoundPort(), 7, 3, 1, ok);
+  EXPECT_EQ(ok, 0);
+
+  CLOSESOCK(mismatched);
+  CLOSESOCK(second);
+  CLOSESOCK(first);
+  tree.Stop();
+}
+
+TEST(spanning_tree_tests, stragglers_time_out)
+{
+  VW::SpanningTree tree(0, true, 1);
+  tree.Start();
+
+  int ok = 0;
+  auto sock = connect_node(tree.BoundPort(), 42, 3, 0, ok);
+  EXPECT_EQ(ok, 1);
+
+  // The job is dropped once the timeout passes, which closes the connection of the node that did show up.
+  uint16_t kid_count = 0;
+  EXPECT_EQ(recv(sock, reinterpret_cast<char*>(&kid_count), sizeof(kid_count), MSG_WAITALL), 0);
+  CLOSESOCK(sock);
+
+  auto metrics = wait_for_jobs(tree, 1);
+  EXPECT_EQ(metrics.jobs_timed_out, 1);
+  EXPECT_EQ(metrics.jobs_completed, 0);
+  tree.Stop();
+}
+
+TEST(spanning_tree_tests, node_leaving_before_ack_leaves_no_job)
+{
+  VW::SpanningTree tree(0, true);
+  tree.Start();
+
+  // Reset the connection right after the handshake so the coordinator cannot ack it.
+  socket_t sock = socket(PF_INET, SOCK_STREAM, 0);
+  sockaddr_in far_end;
+  memset(&far_end, 0, sizeof(far_end));
+  far_end.sin_family = AF_INET;
+  far_end.sin_port = htons(tree.BoundPort());
+  far_end.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&far_end), sizeof(far_end)), 0);
+  linger abort_on_close;
+  abort_on_close.l_onoff = 1;
+  abort_on_close.l_linger = 0;
+  setsockopt(sock, SOL_SOCKET, SO_LINGER, reinterpret_cast<const char*>(&abort_on_close), sizeof(abort_on_close));
+  size_t handshake[] = {9, 3, 0};
+  EXPECT_EQ(send(sock, reinterpret_cast<const char*>(handshake), sizeof(handshake), 0), sizeof(handshake));
+  CLOSESOCK(sock);
+
+  // Without a leftover job the nonce is free for a job of a different size.
+  int ok = 0;
+  auto first = connect_node(tree.BoundPort(), 9, 1, 0, ok);
+  EXPECT_EQ(ok, 1);
+  CLOSESOCK(first);
+
+  auto metrics = wait_for_jobs(tree, 1);
+  EXPECT_EQ(metrics.jobs_in_progress, 0);
+  tree.Stop();
+}
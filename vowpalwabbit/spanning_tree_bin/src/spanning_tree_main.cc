@@ -26,7 +26,8 @@ using namespace VW;
 
 void usage(const VW::config::options_cli& desc)
 {
-  std::cout << "usage: spanning_tree [--port,-p number] [--nondaemon] [--help,-h] [pid_file]" << std::endl;
+  std::cout << "usage: spanning_tree [--port,-p number] [--nondaemon] [--job_timeout seconds] [--help,-h] [pid_file]"
+            << std::endl;
   VW::config::cli_help_formatter help_formatter;
   std::cout << help_formatter.format_help(desc.get_all_option_group_definitions()) << std::endl;
 }
@@ -34,6 +35,7 @@ void usage(const VW::config::options_cli& desc)
 int main(int argc, char* argv[])
 {
   int port = 26543;
+  int job_timeout = 0;
   bool nondaemon = false;
   bool help = false;
 
@@ -45,7 +47,10 @@ int main(int argc, char* argv[])
       .add(VW::config::make_option("port", port)
                .short_name("p")
                .default_value(26543)
-               .help("Port number for spanning tree to listen on"));
+               .help("Port number for spanning tree to listen on"))
+      .add(VW::config::make_option("job_timeout", job_timeout)
+               .default_value(0)
+               .help("Drop jobs whose nodes have not all connected within this many seconds. 0 waits forever"));
 
   opts.add_and_parse(desc);
   // Return value is ignored as option reachability is not relevant here.
@@ -80,7 +85,8 @@ int main(int argc, char* argv[])
       VW_WARNING_STATE_POP
     }
 
-    SpanningTree spanningTree(port);
+    if (job_timeout < 0) { THROW("--job_timeout must not be negative"); }
+    SpanningTree spanningTree(port, false, static_cast<size_t>(job_timeout));
 
     if (!pid_file_name.empty())
     {
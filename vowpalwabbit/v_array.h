@@ -9,6 +9,7 @@
 #include "vw/common/vw_exception.h"
 
 #include <cassert>
+#include <cstdint>
 #include <ostream>
 #include <type_traits>
 #include <utility>
@@ -18,6 +19,21 @@
 
 namespace VW
 {
+/**
+ * \brief Storage a v_array can grow into instead of the heap, see v_array::use_arena(). The v_array never frees it,
+ * the owner of the arena releases everything at once. Implemented by example_arena.
+ */
+class v_array_arena
+{
+public:
+  virtual void* allocate(size_t bytes, size_t alignment) = 0;
+  // Grows the allocation at ptr to new_bytes in place if possible.
+  virtual bool try_extend(void* ptr, size_t old_bytes, size_t new_bytes) = 0;
+
+protected:
+  ~v_array_arena() = default;
+};
+
 /**
  * \brief This is a diagnostic overload used to prevent v_array from being used with types that are not trivially
  * copyable.
@@ -32,6 +48,7 @@ struct v_array;
 /**
  * \brief v_array is a container type that makes use of realloc for efficiency.  However, it is only safe to use
  * trivially copyable types, as std::realloc may do a memcpy if a new piece of memory must be allocated.
+ * Its storage can instead come from a v_array_arena, see use_arena().
  * \tparam T Element type
  */
 template <class T>
@@ -41,6 +58,9 @@ struct v_array<T, typename std::enable_if<std::is_trivially_copyable<T>::value>:
 
 private:
   static constexpr size_t ERASE_POINT = ~((1u << 10u) - 1u);
+  // Set in _erase_count_or_arena when it holds an arena. Else it holds the erase count in steps that leave it clear.
+  static constexpr uintptr_t ARENA_TAG = 1;
+  static constexpr uintptr_t ERASE_STEP = 2;
 
   template <typename S, typename std::enable_if<std::is_trivially_destructible<S>::value, bool>::type = true>
   static void destruct_item(S*)
@@ -59,18 +79,24 @@ private:
     if (_begin != nullptr)
     {
       for (iterator item = _begin; item != _end; ++item) { destruct_item(item); }
-      free(_begin);
+      // Storage from an arena is released all at once when the arena is reset.
+      if (arena() == nullptr) { free(_begin); }
     }
     _begin = nullptr;
     _end = nullptr;
     _end_array = nullptr;
-    _erase_count = 0;
+    if (arena() == nullptr) { _erase_count_or_arena = 0; }
   }
 
   void reserve_nocheck(size_t length)
   {
     if (capacity() == length || length == 0) { return; }
     const size_t old_len = size();
+    if (arena() != nullptr)
+    {
+      reserve_from_arena(old_len, length);
+      return;
+    }
 
     T* temp = static_cast<T*>(std::realloc(_begin, sizeof(T) * length));
     if (temp == nullptr)
@@ -82,6 +108,23 @@ private:
     memset(_end, 0, (_end_array - _end) * sizeof(T));
   }
 
+  // Arena storage only grows: in place when this array holds the latest allocation of the arena, else by copying.
+  // Unlike heap storage, it is not zeroed past size(), so that handing it out costs nothing per element.
+  void reserve_from_arena(size_t old_len, size_t length)
+  {
+    if (length < capacity()) { return; }
+    v_array_arena* storage = arena();
+    if (_begin == nullptr || !storage->try_extend(_begin, sizeof(T) * capacity(), sizeof(T) * length))
+    {
+      T* temp = static_cast<T*>(storage->allocate(sizeof(T) * length, alignof(T)));
+      if (old_len > 0) { memcpy(static_cast<void*>(temp), _begin, sizeof(T) * old_len); }
+      _begin = temp;
+    }
+
+    _end = _begin + old_len;
+    _end_array = _begin + length;
+  }
+
   // This will move all elements after idx by width positions and reallocate the underlying buffer if needed.
   void make_space_at(size_t idx, size_t width)
   {
@@ -108,7 +151,9 @@ private:
   T* _begin;
   T* _end;
   T* _end_array;
-  size_t _erase_count;
+  // The arena the storage comes from with ARENA_TAG set, or else the erase count of clear(). Arenas are aligned, so
+  // the tag never clashes with their address, and v_array stays as small as it was without arenas.
+  uintptr_t _erase_count_or_arena;
 
 public:
   using value_type = T;
@@ -131,12 +176,12 @@ public:
   const_iterator cbegin() const noexcept { return _begin; }
   const_iterator cend() const noexcept { return _end; }
 
-  v_array() noexcept : _begin(nullptr), _end(nullptr), _end_array(nullptr), _erase_count(0) {}
+  v_array() noexcept : _begin(nullptr), _end(nullptr), _end_array(nullptr), _erase_count_or_arena(0) {}
   ~v_array() { delete_v_array(); }
 
   v_array(v_array<T>&& other) noexcept
   {
-    _erase_count = 0;
+    _erase_count_or_arena = 0;
     _begin = nullptr;
     _end = nullptr;
     _end_array = nullptr;
@@ -144,7 +189,7 @@ public:
     std::swap(_begin, other._begin);
     std::swap(_end, other._end);
     std::swap(_end_array, other._end_array);
-    std::swap(_erase_count, other._erase_count);
+    std::swap(_erase_count_or_arena, other._erase_count_or_arena);
   }
 
   v_array& operator=(v_array<T>&& other) noexcept
@@ -152,7 +197,7 @@ public:
     std::swap(_begin, other._begin);
     std::swap(_end, other._end);
     std::swap(_end_array, other._end_array);
-    std::swap(_erase_count, other._erase_count);
+    std::swap(_erase_count_or_arena, other._erase_count_or_arena);
     return *this;
   }
 
@@ -161,7 +206,7 @@ public:
     _begin = nullptr;
     _end = nullptr;
     _end_array = nullptr;
-    _erase_count = 0;
+    _erase_count_or_arena = 0;
 
     copy_into_this(other);
   }
@@ -213,6 +258,8 @@ public:
    */
   void shrink_to_fit()
   {
+    // Arena storage is trimmed by the owner of the arena when it is reset.
+    if (arena() != nullptr) { return; }
     if (size() < capacity())
     {
       if (empty())
@@ -237,6 +284,51 @@ public:
     if (capacity() < length) reserve_nocheck(length);
   }
 
+  /**
+   * \brief Frees the current storage and takes the storage of any further growth from arena, or from the heap if it
+   * is nullptr. The arena must outlive the storage, which moves along with it when this v_array is moved or swapped.
+   */
+  void use_arena(v_array_arena* arena)
+  {
+    delete_v_array();
+    _erase_count_or_arena = arena == nullptr ? 0 : reinterpret_cast<uintptr_t>(arena) | ARENA_TAG;
+  }
+
+  v_array_arena* arena() const
+  {
+    if ((_erase_count_or_arena & ARENA_TAG) == 0) { return nullptr; }
+    return reinterpret_cast<v_array_arena*>(_erase_count_or_arena & ~ARENA_TAG);
+  }
+
+  /**
+   * \brief Empties the container and forgets its arena storage without freeing it, before the arena is reset. The
+   * next allocation still comes from the arena.
+   */
+  void release_arena_storage()
+  {
+    assert(arena() != nullptr);
+    clear_noshrink();
+    _begin = nullptr;
+    _end = nullptr;
+    _end_array = nullptr;
+  }
+
+  /**
+   * \brief Moves the elements to storage the caller took from the arena of this v_array, which must fit capacity
+   * elements, capacity being at least size(). The former storage is left to the arena. Costs O(size()), the storage
+   * past size() is not zeroed.
+   */
+  void move_to_arena_storage(T* storage, size_t capacity)
+  {
+    assert(arena() != nullptr);
+    assert(capacity >= size());
+    const size_t old_len = size();
+    if (old_len > 0) { memcpy(static_cast<void*>(storage), _begin, sizeof(T) * old_len); }
+    _begin = storage;
+    _end = _begin + old_len;
+    _end_array = _begin + capacity;
+  }
+
   // Don't modify the buffer size, just clear the elements
   void clear_noshrink()
   {
@@ -250,10 +342,11 @@ public:
    */
   void clear()
   {
-    if (++_erase_count & ERASE_POINT)
+    // Arena storage is trimmed by the owner of the arena, the erase count is only kept for heap storage.
+    if (arena() == nullptr && ((_erase_count_or_arena += ERASE_STEP) / ERASE_STEP) & ERASE_POINT)
     {
       shrink_to_fit();
-      _erase_count = 0;
+      _erase_count_or_arena = 0;
     }
     clear_noshrink();
   }
@@ -30,6 +30,7 @@
 #include "global_data.h"
 #include "hashstring.h"
 #include "parser.h"
+#include "resolved_setup.h"
 #include "setup_base.h"
 #include "vw/common/hash.h"
 #include "vw_fwd.h"
@@ -50,9 +51,19 @@ VW::workspace* initialize(const std::string& s, io_buf* model = nullptr, bool sk
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
 VW::workspace* initialize(int argc, char* argv[], io_buf* model = nullptr, bool skip_model_load = false,
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
+// Sets up the workspace described by a VW::resolve_setup of another one, without probing every reduction.
+VW::workspace* initialize(const resolved_setup& setup, io_buf* model = nullptr, bool skip_model_load = false,
+    trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
 
 VW::workspace* seed_vw_model(VW::workspace* vw_model, const std::string& extra_args,
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
+// Create a new VW instance sharing the weights and shared data of vw_model, set up from its resolved setup rather than
+// by parsing its options again. Each clone has reductions and examples of its own. Resolve the setup of vw_model once
+// when making many clones.
+VW::workspace* clone_vw_model(
+    VW::workspace* vw_model, trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
+VW::workspace* clone_vw_model(VW::workspace* vw_model, const resolved_setup& setup,
+    trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
 // Allows the input command line string to have spaces escaped by '\'
 VW::workspace* initialize_escaped(std::string const& s, io_buf* model = nullptr, bool skip_model_load = false,
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
@@ -29,5 +29,12 @@ void all_reduce(VW::workspace& all, T* buffer, const size_t n)
       all_reduce_threads_ptr->all_reduce<T, f>(buffer, n);
       break;
     }
+    case AllReduceType::SharedMemory:
+    {
+      auto* all_reduce_shm_ptr = dynamic_cast<AllReduceSharedMemory*>(all.all_reduce);
+      if (all_reduce_shm_ptr == nullptr) { THROW("all_reduce was not a AllReduceSharedMemory* object") }
+      all_reduce_shm_ptr->all_reduce<T, f>(buffer, n);
+      break;
+    }
   }
 }